@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "common.h"
+#include "entity.h"
+
+/* Compare the status effects tick over the hot/cold split entity chunks
+ * against the layouts that keep the text next to the hot data. The tick walks
+ * the world chunk after chunk, like effectsTick() and the parallel systems,
+ * so the caches only hold what it streams in.
+ *
+ * - rows: one struct per entity, text pointers between the hot fields. Every
+ *   cache line streamed in carries the text the tick never reads.
+ * - mixed: the chunks before the split, text columns in the same chunk as
+ *   the hot ones. Being separate arrays, they are never streamed in either,
+ *   the split only saves their footprint in the large arena.
+ * - split: the hot chunks of entity.h. */
+
+#define ENTITY_COUNT (MAX_ENTITIES - 1)
+#define TICKS 20
+#define RUNS 5
+/* Larger than the last level cache. Rendering and the other systems run
+ * between two ticks, so a tick starts with its data out of the cache. */
+#define EVICT_SIZE (64 * 1024 * 1024)
+#define CACHE_LINE 64
+
+struct MixedChunk {
+	const char *names[ENTITY_CHUNK_SIZE];
+	const char *description[ENTITY_CHUNK_SIZE];
+	float healths[ENTITY_CHUNK_SIZE];
+	float maxHealths[ENTITY_CHUNK_SIZE];
+	float damageOverTime[ENTITY_CHUNK_SIZE];
+	float regeneration[ENTITY_CHUNK_SIZE];
+	EntityIdx location[ENTITY_CHUNK_SIZE];
+	EntityType types[ENTITY_CHUNK_SIZE];
+};
+
+/* One row per entity, hot and cold fields together */
+struct EntityRecord {
+	const char *name;
+	float health;
+	float maxHealth;
+	const char *description;
+	float damageOverTime;
+	float regeneration;
+	EntityIdx location;
+	EntityType type;
+};
+
+static struct EntityComponents components;
+static struct EntityRecord *records;
+static struct MixedChunk *mixedChunks[MAX_ENTITY_CHUNKS];
+static u64 deaths;
+
+/* The status effects tick of effects.c, scalar so every layout runs the same
+ * code */
+static inline void tickEntity(float *health, float max, float dot, float regen)
+{
+	if (!(*health > 0.0f)) {
+		return;
+	}
+
+	float next = *health + (1.0f / 30.0f) * (regen - dot);
+	float cap = *health > max ? *health : max;
+	next = next < cap ? next : cap;
+	next = next > 0.0f ? next : 0.0f;
+	*health = next;
+	deaths += next <= 0.0f;
+}
+
+#define TICK_CHUNKS(chunks)\
+	for (size_t c = 0; c < MAX_ENTITY_CHUNKS; c++) {\
+		for (size_t o = 0; o < ENTITY_CHUNK_SIZE; o++) {\
+			tickEntity(&chunks[c]->healths[o],\
+				   chunks[c]->maxHealths[o],\
+				   chunks[c]->damageOverTime[o],\
+				   chunks[c]->regeneration[o]);\
+		}\
+	}
+
+static void tickSplit(void)
+{
+	TICK_CHUNKS(components.chunks);
+}
+
+static void tickMixed(void)
+{
+	TICK_CHUNKS(mixedChunks);
+}
+
+static void tickRecords(void)
+{
+	for (size_t e = 0; e < MAX_ENTITIES; e++) {
+		struct EntityRecord *r = &records[e];
+		tickEntity(&r->health, r->maxHealth, r->damageOverTime,
+			   r->regeneration);
+	}
+}
+
+static void evictCaches(void)
+{
+	static volatile char *scratch;
+
+	if (scratch == NULL) {
+		scratch = largeArenaAlloc(EVICT_SIZE, CACHE_LINE);
+	}
+
+	for (size_t i = 0; i < EVICT_SIZE; i += CACHE_LINE) {
+		scratch[i] += 1;
+	}
+}
+
+static double measure(void (*tick)(void))
+{
+	u64 best = UINT64_MAX;
+
+	for (int run = 0; run < RUNS; run++) {
+		u64 elapsed = 0;
+		for (int i = 0; i < TICKS; i++) {
+			evictCaches();
+			u64 start = get_nanoseconds();
+			tick();
+			elapsed += get_nanoseconds() - start;
+		}
+		best = elapsed < best ? elapsed : best;
+	}
+
+	return (double)best / ((double)TICKS * ENTITY_COUNT);
+}
+
+/* Cache lines a tick streams in per entity */
+static double linesPerEntity(size_t bytesRead)
+{
+	return (double)bytesRead / CACHE_LINE;
+}
+
+static void fill(void)
+{
+	u32 state = 1;
+
+	entityComponentsInit(&components);
+	entityComponentsReserve(&components, MAX_ENTITIES);
+
+	for (size_t c = 0; c < MAX_ENTITY_CHUNKS; c++) {
+		mixedChunks[c] = largeArenaAlloc(sizeof(struct MixedChunk),
+						 CACHE_LINE);
+		memset(mixedChunks[c], 0, sizeof(struct MixedChunk));
+	}
+
+	records = largeArenaAlloc(sizeof(struct EntityRecord) * MAX_ENTITIES,
+				  CACHE_LINE);
+	memset(records, 0, sizeof(struct EntityRecord) * MAX_ENTITIES);
+
+	/* Most entities are healthy, a few regenerate or burn */
+	for (size_t e = 1; e < MAX_ENTITIES; e++) {
+		state = state * 1664525u + 1013904223u;
+		float health = (float)((state >> 8) % 100 + 1);
+		float max = 100.0f;
+		float dot = (state >> 20) % 8 == 0 ? 0.5f : 0.0f;
+		float regen = (state >> 24) % 8 == 0 ? 0.5f : 0.0f;
+
+		ENTITY(&components, healths, e) = health;
+		ENTITY(&components, maxHealths, e) = max;
+		ENTITY(&components, damageOverTime, e) = dot;
+		ENTITY(&components, regeneration, e) = regen;
+
+		size_t c = e / ENTITY_CHUNK_SIZE;
+		size_t o = e % ENTITY_CHUNK_SIZE;
+		mixedChunks[c]->healths[o] = health;
+		mixedChunks[c]->maxHealths[o] = max;
+		mixedChunks[c]->damageOverTime[o] = dot;
+		mixedChunks[c]->regeneration[o] = regen;
+
+		records[e].health = health;
+		records[e].maxHealth = max;
+		records[e].damageOverTime = dot;
+		records[e].regeneration = regen;
+	}
+}
+
+int main(void)
+{
+	initArena();
+	fill();
+
+	double rows = measure(tickRecords);
+	double mixed = measure(tickMixed);
+	double split = measure(tickSplit);
+
+	/* The tick reads four floats per entity */
+	size_t columnBytes = 4 * sizeof(float);
+
+	printf("%d entities, %d ticks, best of %d\n", ENTITY_COUNT, TICKS, RUNS);
+	printf("rows (%.2f lines per entity): %.2f ns/entity\n",
+	       linesPerEntity(sizeof(struct EntityRecord)), rows);
+	printf("hot and cold mixed (%.2f lines per entity, %zu bytes per "
+	       "chunk): %.2f ns/entity\n", linesPerEntity(columnBytes),
+	       sizeof(struct MixedChunk), mixed);
+	printf("hot/cold split (%.2f lines per entity, %zu bytes per hot "
+	       "chunk): %.2f ns/entity\n", linesPerEntity(columnBytes),
+	       sizeof(struct EntityChunk), split);
+	printf("%llu deaths\n", (unsigned long long)deaths);
+
+	cleanupArena();
+	return 0;
+}
@@ -0,0 +1,123 @@
+/* Laying out a frame with Clay, shared by the game's views. Include it after
+ * clay.h's implementation. The includer provides getLayoutDimensions(),
+ * configureClay(), which sets Clay's per-context settings again whenever the
+ * context is replaced, and createLayout(), from Clay_BeginLayout() to
+ * Clay_EndLayout(). */
+#include "clay.h"
+#include "clay_memory.h"
+#include "../profiler.h"
+
+/* Clay's own capacity, see Clay__InitializePersistentMemory() */
+#define CLAY_MAX_SCROLL_CONTAINERS 100
+
+/* What a new context would lose of the frames before: where the scroll
+ * containers are scrolled and what the pointer does */
+struct ClayCarriedState {
+	Clay__ScrollContainerDataInternal scrolls[CLAY_MAX_SCROLL_CONTAINERS];
+	i32 scrollCount;
+	Clay_PointerData pointer;
+};
+
+static Clay_Dimensions getLayoutDimensions(void);
+static void configureClay(void);
+static Clay_RenderCommandArray createLayout(void);
+
+static Error initLayout(void)
+{
+	Error err = initClayMemory(getLayoutDimensions());
+	if (err != ERR_OK) {
+		return err;
+	}
+
+	configureClay();
+
+	return ERR_OK;
+}
+
+static void createScrollBar(Clay_ScrollContainerData scrollData)
+{
+	if (!scrollData.found) {
+		return;
+	}
+
+	Clay_ElementDeclaration scrollBar
+		= getScrollBar(CLAY_STRING("MainContent"), scrollData);
+	Clay_ElementDeclaration scrollBarButton
+		= getScrollBarButton(CLAY_STRING("ScrollBar"), scrollData);
+
+	CLAY(CLAY_ID("ScrollBar"), scrollBar) {
+		CLAY(CLAY_ID("ScrollBarButton"), scrollBarButton) {}
+	}
+}
+
+static void recordClayUsage(void)
+{
+	Clay_Context *ctx = Clay_GetCurrentContext();
+	i32 elementCount = ctx->layoutElements.length;
+
+	if (ctx->measureTextHashMapInternal.length > elementCount) {
+		elementCount = ctx->measureTextHashMapInternal.length;
+	}
+
+	clayMemoryRecordUsage(elementCount, ctx->measuredWords.length,
+			      ctx->booleanWarnings.maxElementsExceeded);
+}
+
+static void saveCarriedState(struct ClayCarriedState *state)
+{
+	Clay_Context *ctx = Clay_GetCurrentContext();
+
+	state->scrollCount = MIN(ctx->scrollContainerDatas.length,
+				 CLAY_MAX_SCROLL_CONTAINERS);
+	memcpy(state->scrolls, ctx->scrollContainerDatas.internalArray,
+	       sizeof(state->scrolls[0]) * (size_t)state->scrollCount);
+	state->pointer = ctx->pointerInfo;
+}
+
+/* The containers are found by id when the next layout opens them again */
+static void restoreCarriedState(const struct ClayCarriedState *state)
+{
+	Clay_Context *ctx = Clay_GetCurrentContext();
+
+	for (i32 i = 0; i < state->scrollCount; i++) {
+		Clay__ScrollContainerDataInternal scroll = state->scrolls[i];
+		scroll.layoutElement = NULL;
+		scroll.openThisFrame = false;
+		Clay__ScrollContainerDataInternalArray_Add(
+			&ctx->scrollContainerDatas, scroll);
+	}
+	ctx->pointerInfo = state->pointer;
+}
+
+static Clay_RenderCommandArray profileLayout(void)
+{
+	u64 start = profilerBegin();
+	Clay_RenderCommandArray renderCommands = createLayout();
+	profilerEnd(PROFILE_ZONE_LAYOUT, start);
+
+	return renderCommands;
+}
+
+static Clay_RenderCommandArray layOut(void)
+{
+	Clay_RenderCommandArray renderCommands = profileLayout();
+	recordClayUsage();
+
+	/* The layout ran out of capacity and dropped elements, lay it out again
+	 * in a larger arena instead of drawing an incomplete frame. Without the
+	 * carried state, MainContent would jump back to the top. */
+	while (clayMemoryOverflowed()) {
+		static struct ClayCarriedState carried;
+		saveCarriedState(&carried);
+
+		if (growClayMemory(getLayoutDimensions()) != ERR_OK) {
+			break;
+		}
+		configureClay();
+		restoreCarriedState(&carried);
+		renderCommands = profileLayout();
+		recordClayUsage();
+	}
+
+	return renderCommands;
+}
@@ -0,0 +1,174 @@
+#include "clay_memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "../memstats.h"
+
+#ifndef CLAY_MEMORY_STATS_FILE
+#define CLAY_MEMORY_STATS_FILE "clay_memory.stats"
+#endif
+
+/* Clay's own defaults, the arena never starts smaller */
+#define CLAY_MIN_ELEMENT_COUNT 8192
+#define CLAY_MIN_WORD_COUNT 16384
+
+struct ClayUsage {
+	i32 elementCount;
+	i32 wordCount;
+};
+
+static void *clayMemory;
+static struct ClayUsage capacity;
+/* Peaks of this run merged with the ones loaded from the stats file */
+static struct ClayUsage peak;
+static bool elementsOverflowed;
+static bool wordsOverflowed;
+
+static void handleClayError(Clay_ErrorData errorData)
+{
+	errorf("%.*s\n", errorData.errorText.length, errorData.errorText.chars);
+
+	if (errorData.errorType == CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED) {
+		elementsOverflowed = true;
+	} else if (errorData.errorType == CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED) {
+		wordsOverflowed = true;
+	}
+}
+
+static i32 capacityFor(i32 count, i32 minimum)
+{
+	/* A quarter of headroom, rounded up to a multiple of 1024 */
+	i32 wanted = count + count / 4;
+	wanted = (wanted + 1023) & ~1023;
+
+	return wanted > minimum ? wanted : minimum;
+}
+
+static void loadStats(void)
+{
+	FILE *file = fopen(CLAY_MEMORY_STATS_FILE, "r");
+
+	if (file == NULL) {
+		/* First run, keep Clay's defaults */
+		return;
+	}
+
+	struct ClayUsage loaded = { 0 };
+	if (fscanf(file, "elements %d words %d", &loaded.elementCount,
+		   &loaded.wordCount) == 2
+	    && loaded.elementCount >= 0 && loaded.wordCount >= 0) {
+		peak = loaded;
+	}
+
+	(void)fclose(file);
+}
+
+static void saveStats(void)
+{
+	FILE *file = fopen(CLAY_MEMORY_STATS_FILE, "w");
+
+	if (file == NULL) {
+		errorf("Error: unable to write %s\n", CLAY_MEMORY_STATS_FILE);
+		return;
+	}
+
+	(void)fprintf(file, "elements %d\nwords %d\n", peak.elementCount,
+		      peak.wordCount);
+	(void)fclose(file);
+}
+
+/* Initialize Clay in a new arena of `capacity`, then free the old one. Clay
+ * copies its settings from the current context, so it must still be alive. */
+static Error allocateClayMemory(Clay_Dimensions layoutDimensions)
+{
+	Clay_SetMaxElementCount(capacity.elementCount);
+	Clay_SetMaxMeasureTextCacheWordCount(capacity.wordCount);
+
+	u32 size = Clay_MinMemorySize();
+	void *memory = memTrackedRealloc(MEM_TAG_CLAY, NULL, size);
+	Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(size, memory);
+
+	Clay_Context *ctx = Clay_Initialize(
+		arena,
+		layoutDimensions,
+		(Clay_ErrorHandler) { handleClayError, 0 });
+	if (ctx == NULL) {
+		memTrackedFree(MEM_TAG_CLAY, memory);
+		return ERR_OUT_OF_MEMORY;
+	}
+
+	if (clayMemory != NULL) {
+		memTrackedFree(MEM_TAG_CLAY, clayMemory);
+	}
+	clayMemory = memory;
+
+	return ERR_OK;
+}
+
+Error initClayMemory(Clay_Dimensions layoutDimensions)
+{
+	assert(clayMemory == NULL);
+
+	peak = (struct ClayUsage) { 0 };
+	loadStats();
+
+	capacity.elementCount = capacityFor(peak.elementCount,
+					    CLAY_MIN_ELEMENT_COUNT);
+	capacity.wordCount = capacityFor(peak.wordCount, CLAY_MIN_WORD_COUNT);
+	elementsOverflowed = false;
+	wordsOverflowed = false;
+
+	return allocateClayMemory(layoutDimensions);
+}
+
+Error cleanupClayMemory(void)
+{
+	saveStats();
+
+	Clay_SetCurrentContext(NULL);
+	memTrackedFree(MEM_TAG_CLAY, clayMemory);
+	clayMemory = NULL;
+
+	return ERR_OK;
+}
+
+void clayMemoryRecordUsage(i32 elementCount, i32 wordCount,
+			   bool elementsExceeded)
+{
+	if (elementsExceeded) {
+		elementsOverflowed = true;
+	}
+
+	if (elementCount > peak.elementCount) {
+		peak.elementCount = elementCount;
+	}
+	if (wordCount > peak.wordCount) {
+		peak.wordCount = wordCount;
+	}
+}
+
+bool clayMemoryOverflowed(void)
+{
+	return elementsOverflowed || wordsOverflowed;
+}
+
+Error growClayMemory(Clay_Dimensions layoutDimensions)
+{
+	assert(clayMemoryOverflowed());
+
+	/* The overflowing layout was cut short, its counts are not the real
+	 * need. Remember at least the capacity it hit. */
+	if (elementsOverflowed) {
+		clayMemoryRecordUsage(capacity.elementCount, 0, false);
+		capacity.elementCount *= 2;
+	}
+	if (wordsOverflowed) {
+		clayMemoryRecordUsage(0, capacity.wordCount, false);
+		capacity.wordCount *= 2;
+	}
+	elementsOverflowed = false;
+	wordsOverflowed = false;
+
+	return allocateClayMemory(layoutDimensions);
+}
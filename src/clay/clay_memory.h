@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "../errors.h"
+#include "../laz_utils.h"
+#include "clay.h"
+
+/* Owns the memory Clay lays out in. The peak element and measured word counts
+ * are saved in CLAY_MEMORY_STATS_FILE on cleanup, and the next run sizes the
+ * arena from them once at startup. When a layout still runs out of capacity,
+ * `growClayMemory()` moves Clay to a larger arena and frees the old one, the
+ * caller then redoes the layout in the same frame. */
+
+Error initClayMemory(Clay_Dimensions layoutDimensions);
+Error cleanupClayMemory(void);
+
+/* Report the counts used by the layout that just ended. Clay flags running out
+ * of elements in its context instead of calling the error handler, the caller
+ * passes the flag along in `elementsExceeded`. */
+void clayMemoryRecordUsage(i32 elementCount, i32 wordCount,
+			   bool elementsExceeded);
+/* True if Clay ran out of capacity since the last `growClayMemory()` */
+bool clayMemoryOverflowed(void);
+/* Double the capacities that overflowed and reinitialize Clay. Clay's context
+ * is replaced, its per-context settings (text measurement, debug mode) must
+ * be set again, and its scroll positions copied over, see clay_frame.c. */
+Error growClayMemory(Clay_Dimensions layoutDimensions);
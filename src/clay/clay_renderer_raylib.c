@@ -5,6 +5,8 @@
 #include "stdio.h"
 #include "stdlib.h"
 
+#include "text_measure.h"
+
 #define CLAY_RECTANGLE_TO_RAYLIB_RECTANGLE(rectangle) (Rectangle) { .x = rectangle.x, .y = rectangle.y, .width = rectangle.width, .height = rectangle.height }
 #define CLAY_COLOR_TO_RAYLIB_COLOR(color) (Color) { .r = (unsigned char)roundf(color.r), .g = (unsigned char)roundf(color.g), .b = (unsigned char)roundf(color.b), .a = (unsigned char)roundf(color.a) }
 
@@ -129,47 +131,144 @@ Ray GetScreenToWorldPointWithZDistance(Vector2 position, Camera camera, int scre
 }
 
 
-static inline Clay_Dimensions Raylib_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
-    // Measure string size for Font
-    Clay_Dimensions textSize = { 0 };
+// Advances of a font at one size, in pixels, so measuring text is a table lookup per character.
+// ASCII is a flat array, other codepoints go through a small open-addressing table filled as they
+// are met: raylib's GetGlyphIndex() is a linear search through the font's glyphs.
+#define RAYLIB_GLYPH_TABLE_COUNT 16
+#define RAYLIB_GLYPH_HASH_SIZE 256
 
-    float maxTextWidth = 0.0f;
-    float lineTextWidth = 0;
-    int maxLineCharCount = 0;
-    int lineCharCount = 0;
+typedef struct
+{
+    int32_t codepoint; // -1 when empty
+    float advance;
+} Raylib_HashedAdvance;
 
-    float textHeight = config->fontSize;
-    Font* fonts = (Font*)userData;
-    Font fontToUse = fonts[config->fontId];
+typedef struct
+{
+    // What the table was built for, a font reloaded at another address is built again
+    const Font *fonts;
+    const GlyphInfo *glyphs;
+    uint16_t fontId;
+    uint16_t fontSize;
+    bool used;
+    float ascii[128];
+    Raylib_HashedAdvance hashed[RAYLIB_GLYPH_HASH_SIZE];
+    int hashedCount;
+} Raylib_GlyphAdvances;
+
+static Raylib_GlyphAdvances Raylib_glyphAdvances[RAYLIB_GLYPH_TABLE_COUNT];
+// Next table to replace once they are all used
+static int Raylib_glyphAdvancesNext;
+static Font Raylib_defaultFont;
+
+static const Font *Raylib_GetFontToUse(const Font *fonts, uint16_t fontId) {
     // Font failed to load, likely the fonts are in the wrong place relative to the execution dir.
-    // RayLib ships with a default font, so we can continue with that built in one. 
-    if (!fontToUse.glyphs) {
-        fontToUse = GetFontDefault();
+    // RayLib ships with a default font, so we can continue with that built in one.
+    if (fonts[fontId].glyphs) {
+        return &fonts[fontId];
+    }
+    if (!Raylib_defaultFont.glyphs) {
+        Raylib_defaultFont = GetFontDefault();
+    }
+    return &Raylib_defaultFont;
+}
+
+static float Raylib_ComputeAdvance(const Font *font, int codepoint, float scaleFactor) {
+    int index = GetGlyphIndex(*font, codepoint);
+    float advance = font->glyphs[index].advanceX != 0
+        ? (float)font->glyphs[index].advanceX
+        : font->recs[index].width + (float)font->glyphs[index].offsetX;
+    return advance * scaleFactor;
+}
+
+static Raylib_GlyphAdvances *Raylib_GetGlyphAdvances(const Font *fonts, uint16_t fontId, uint16_t fontSize) {
+    const Font *font = Raylib_GetFontToUse(fonts, fontId);
+
+    for (int i = 0; i < RAYLIB_GLYPH_TABLE_COUNT; i++) {
+        Raylib_GlyphAdvances *advances = &Raylib_glyphAdvances[i];
+        if (advances->used && advances->fonts == fonts && advances->glyphs == font->glyphs
+            && advances->fontId == fontId && advances->fontSize == fontSize) {
+            return advances;
+        }
     }
 
-    float scaleFactor = config->fontSize/(float)fontToUse.baseSize;
+    Raylib_GlyphAdvances *advances = &Raylib_glyphAdvances[Raylib_glyphAdvancesNext];
+    Raylib_glyphAdvancesNext = (Raylib_glyphAdvancesNext + 1) % RAYLIB_GLYPH_TABLE_COUNT;
 
-    for (int i = 0; i < text.length; ++i, lineCharCount++)
-    {
-        if (text.chars[i] == '\n') {
-            maxTextWidth = fmax(maxTextWidth, lineTextWidth);
-            maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
-            lineTextWidth = 0;
-            lineCharCount = 0;
-            continue;
+    float scaleFactor = fontSize / (float)font->baseSize;
+    *advances = (Raylib_GlyphAdvances) {
+        .fonts = fonts,
+        .glyphs = font->glyphs,
+        .fontId = fontId,
+        .fontSize = fontSize,
+        .used = true,
+    };
+    for (int codepoint = 0; codepoint < 128; codepoint++) {
+        advances->ascii[codepoint] = Raylib_ComputeAdvance(font, codepoint, scaleFactor);
+    }
+    for (int i = 0; i < RAYLIB_GLYPH_HASH_SIZE; i++) {
+        advances->hashed[i].codepoint = -1;
+    }
+
+    return advances;
+}
+
+static float Raylib_GetAdvance(Raylib_GlyphAdvances *advances, const Font *fonts, int codepoint) {
+    if (codepoint < 128) {
+        return advances->ascii[codepoint];
+    }
+
+    uint32_t slot = ((uint32_t)codepoint * 2654435761u) & (RAYLIB_GLYPH_HASH_SIZE - 1);
+    while (advances->hashed[slot].codepoint != -1) {
+        if (advances->hashed[slot].codepoint == codepoint) {
+            return advances->hashed[slot].advance;
         }
-        int index = text.chars[i] - 32;
-        if (fontToUse.glyphs[index].advanceX != 0) lineTextWidth += fontToUse.glyphs[index].advanceX;
-        else lineTextWidth += (fontToUse.recs[index].width + fontToUse.glyphs[index].offsetX);
+        slot = (slot + 1) & (RAYLIB_GLYPH_HASH_SIZE - 1);
     }
 
-    maxTextWidth = fmax(maxTextWidth, lineTextWidth);
-    maxLineCharCount = CLAY__MAX(maxLineCharCount, lineCharCount);
+    const Font *font = Raylib_GetFontToUse(fonts, advances->fontId);
+    float advance = Raylib_ComputeAdvance(font, codepoint, advances->fontSize / (float)font->baseSize);
+    // Kept at most three quarters full, past that the rare codepoints are computed each time
+    if (advances->hashedCount < RAYLIB_GLYPH_HASH_SIZE * 3 / 4) {
+        advances->hashed[slot] = (Raylib_HashedAdvance) { codepoint, advance };
+        advances->hashedCount++;
+    }
+    return advance;
+}
 
-    textSize.width = maxTextWidth * scaleFactor + (lineCharCount * config->letterSpacing);
-    textSize.height = textHeight;
+static inline Clay_Dimensions Raylib_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    const Font *fonts = (const Font *)userData;
+    Raylib_GlyphAdvances *advances = Raylib_GetGlyphAdvances(fonts, config->fontId, config->fontSize);
+    const unsigned char *chars = (const unsigned char *)text.chars;
+    float maxTextWidth = 0.0f;
+    float lineTextWidth = 0.0f;
+    int lineCodepoints = 0;
+    int i = 0;
+
+    while (i < text.length) {
+        int run = textAsciiRunLength(chars + i, text.length - i);
+        if (run > 0) {
+            lineTextWidth += textSumAsciiAdvances(advances->ascii, chars + i, run);
+            lineCodepoints += run;
+            i += run;
+            continue;
+        }
+        if (chars[i] == '\n') {
+            maxTextWidth = fmaxf(maxTextWidth, lineTextWidth + lineCodepoints * config->letterSpacing);
+            lineTextWidth = 0;
+            lineCodepoints = 0;
+            i++;
+            continue;
+        }
+        int size = 1;
+        int codepoint = textDecodeUtf8(chars + i, text.length - i, &size);
+        lineTextWidth += Raylib_GetAdvance(advances, fonts, codepoint);
+        lineCodepoints++;
+        i += size;
+    }
+    maxTextWidth = fmaxf(maxTextWidth, lineTextWidth + lineCodepoints * config->letterSpacing);
 
-    return textSize;
+    return (Clay_Dimensions) { .width = maxTextWidth, .height = config->fontSize };
 }
 
 void Clay_Raylib_Initialize(int width, int height, const char *title, unsigned int flags) {
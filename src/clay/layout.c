@@ -1,5 +1,6 @@
+/* Style of the game's screen. Hover feedback calls raylib's
+ * IsCursorOnScreen() and SetMouseCursor(), which the includer provides. */
 #include "clay.h"
-#include "clay_renderer_raylib.c"
 #include "../common.h"
 
 /* Colors */
@@ -26,6 +27,15 @@ static Clay_TextElementConfig getFontBody(void)
 	};
 }
 
+static Clay_TextElementConfig getFontDebug(void)
+{
+	return (Clay_TextElementConfig) {
+		.fontSize = 16,
+		.fontId = FONT_ID_BODY_16,
+		.textColor = COLOR_TEXT
+	};
+}
+
 static Clay_TextElementConfig getFontAction(void)
 {
 	Clay_TextElementConfig body = getFontBody();
@@ -115,6 +125,17 @@ static Clay_ElementDeclaration getActionButton(bool *hoveredOut)
 	return button;
 }
 
+/* Also where the view places the message rows it doesn't lay out */
+static Clay_LayoutConfig getMainContentLayout(void)
+{
+	Clay_LayoutConfig layout = getPanel().layout;
+
+	layout.sizing.height = CLAY_SIZING_GROW(0);
+	layout.padding = (Clay_Padding) { 27, 27, 31, 31 };
+
+	return layout;
+}
+
 static Clay_ElementDeclaration getMainContent(void)
 {
 	Clay_ElementDeclaration panel = getPanel();
@@ -123,8 +144,23 @@ static Clay_ElementDeclaration getMainContent(void)
 		.vertical = true,
 		.childOffset = Clay_GetScrollOffset()
 	};
-	panel.layout.sizing.height = CLAY_SIZING_GROW(0);
-	panel.layout.padding = (Clay_Padding) { 27, 27, 31, 31 };
+	panel.layout = getMainContentLayout();
+
+	return panel;
+}
+
+static Clay_ElementDeclaration getDebugOverlay(void)
+{
+	Clay_ElementDeclaration panel = getPanel();
+
+	panel.layout.sizing.width = CLAY_SIZING_FIT(0);
+	panel.layout.padding = CLAY_PADDING_ALL(10);
+	panel.layout.childGap = 2;
+	panel.floating = (Clay_FloatingElementConfig) {
+		.attachTo = CLAY_ATTACH_TO_ROOT,
+		.offset = { 8, 8 },
+		.zIndex = 2,
+	};
 
 	return panel;
 }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../simd.h"
+
+/* Scanning of the UTF-8 text the renderer measures, apart from raylib so it
+ * can be tested on its own */
+
+/* Decodes the UTF-8 sequence at the start of `chars`, never reading past
+ * `length`. Invalid or truncated sequences decode to '?' one byte at a time,
+ * like raylib's GetCodepointNext(). */
+static inline int textDecodeUtf8(const unsigned char *chars, int length,
+				 int *size)
+{
+	/* Overlong encodings are below these */
+	static const int minimum[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+	unsigned char lead = chars[0];
+	int count = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+	int codepoint = count == 4 ? lead & 0x07
+		: count == 3 ? lead & 0x0F : lead & 0x1F;
+
+	*size = 1;
+	if (count == 1 || lead >= 0xF8 || count > length) {
+		return lead < 0x80 ? lead : '?';
+	}
+	for (int i = 1; i < count; i++) {
+		if ((chars[i] & 0xC0) != 0x80) {
+			return '?';
+		}
+		codepoint = (codepoint << 6) | (chars[i] & 0x3F);
+	}
+	/* Overlong encodings, surrogates and values past Unicode */
+	if (codepoint < minimum[count]
+	    || (codepoint >= 0xD800 && codepoint <= 0xDFFF)
+	    || codepoint > 0x10FFFF) {
+		return '?';
+	}
+	*size = count;
+	return codepoint;
+}
+
+/* Length of the run of ASCII characters other than newlines at the start of
+ * `chars` */
+static inline int textAsciiRunLength(const unsigned char *chars, int length)
+{
+	int run = 0;
+#if SIMD_SSE2
+	const __m128i newline = _mm_set1_epi8('\n');
+	while (run + 16 <= length) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(chars + run));
+		/* High bits start UTF-8 sequences */
+		u32 stops = (u32)_mm_movemask_epi8(block)
+			| (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+		if (stops) {
+			return run + simdLowestBit(stops);
+		}
+		run += 16;
+	}
+#endif
+	while (run < length && chars[run] < 0x80 && chars[run] != '\n') {
+		run++;
+	}
+	return run;
+}
+
+/* Sum of the advances of `length` ASCII characters, `ascii` holding the
+ * advance of each of the 128 */
+static inline float textSumAsciiAdvances(const float *ascii,
+					 const unsigned char *chars,
+					 int length)
+{
+	int i = 0;
+	float total = 0;
+#if SIMD_AVX2
+	__m256 sum = _mm256_setzero_ps();
+	for (; i + 8 <= length; i += 8) {
+		__m128i bytes = _mm_loadl_epi64((const __m128i *)(chars + i));
+		sum = _mm256_add_ps(sum, _mm256_i32gather_ps(ascii,
+			_mm256_cvtepu8_epi32(bytes), 4));
+	}
+	__m128 half = _mm_add_ps(_mm256_castps256_ps128(sum),
+				 _mm256_extractf128_ps(sum, 1));
+	half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+	half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+	total = _mm_cvtss_f32(half);
+#else
+	/* Independent sums, so the additions don't wait on each other */
+	float sums[4] = { 0 };
+	for (; i + 4 <= length; i += 4) {
+		sums[0] += ascii[chars[i]];
+		sums[1] += ascii[chars[i + 1]];
+		sums[2] += ascii[chars[i + 2]];
+		sums[3] += ascii[chars[i + 3]];
+	}
+	total = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#endif
+	for (; i < length; i++) {
+		total += ascii[chars[i]];
+	}
+	return total;
+}
@@ -0,0 +1,143 @@
+#include <assert.h>
+
+#include "effects.h"
+#include "simd.h"
+
+/* Entities per iteration, one bit each in the mask of deaths */
+#define EFFECTS_BLOCK 16
+
+_Static_assert(ENTITY_CHUNK_SIZE % EFFECTS_BLOCK == 0,
+	       "ENTITY_CHUNK_SIZE must be a multiple of the effects block size");
+
+#if SIMD_AVX2
+static u32 tickBlock(struct EntityChunk *c, size_t base, float seconds)
+{
+	__m256 zero = _mm256_setzero_ps();
+	__m256 dt = _mm256_set1_ps(seconds);
+	u32 died = 0;
+
+	for (size_t i = 0; i < EFFECTS_BLOCK; i += 8) {
+		float *healths = &c->healths[base + i];
+		__m256 health = _mm256_loadu_ps(healths);
+		__m256 max = _mm256_loadu_ps(&c->maxHealths[base + i]);
+		__m256 delta = _mm256_mul_ps(dt, _mm256_sub_ps(
+			_mm256_loadu_ps(&c->regeneration[base + i]),
+			_mm256_loadu_ps(&c->damageOverTime[base + i])));
+
+		__m256 alive = _mm256_cmp_ps(health, zero, _CMP_GT_OQ);
+		__m256 next = _mm256_min_ps(_mm256_add_ps(health, delta),
+					    _mm256_max_ps(health, max));
+		next = _mm256_max_ps(next, zero);
+		next = _mm256_blendv_ps(health, next, alive);
+		_mm256_storeu_ps(healths, next);
+
+		__m256 dead = _mm256_and_ps(
+			alive, _mm256_cmp_ps(next, zero, _CMP_LE_OQ));
+		died |= (u32)_mm256_movemask_ps(dead) << i;
+	}
+
+	return died;
+}
+#elif SIMD_SSE2
+static u32 tickBlock(struct EntityChunk *c, size_t base, float seconds)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 dt = _mm_set1_ps(seconds);
+	u32 died = 0;
+
+	for (size_t i = 0; i < EFFECTS_BLOCK; i += 4) {
+		float *healths = &c->healths[base + i];
+		__m128 health = _mm_loadu_ps(healths);
+		__m128 max = _mm_loadu_ps(&c->maxHealths[base + i]);
+		__m128 delta = _mm_mul_ps(dt, _mm_sub_ps(
+			_mm_loadu_ps(&c->regeneration[base + i]),
+			_mm_loadu_ps(&c->damageOverTime[base + i])));
+
+		__m128 alive = _mm_cmpgt_ps(health, zero);
+		__m128 next = _mm_min_ps(_mm_add_ps(health, delta),
+					 _mm_max_ps(health, max));
+		next = _mm_max_ps(next, zero);
+		/* No blend in SSE2 */
+		next = _mm_or_ps(_mm_and_ps(alive, next),
+				 _mm_andnot_ps(alive, health));
+		_mm_storeu_ps(healths, next);
+
+		__m128 dead = _mm_and_ps(alive, _mm_cmple_ps(next, zero));
+		died |= (u32)_mm_movemask_ps(dead) << i;
+	}
+
+	return died;
+}
+#else
+static u32 tickBlock(struct EntityChunk *c, size_t base, float seconds)
+{
+	u32 died = 0;
+
+	for (size_t i = 0; i < EFFECTS_BLOCK; i++) {
+		float health = c->healths[base + i];
+		if (!(health > 0.0f)) {
+			continue;
+		}
+
+		float max = c->maxHealths[base + i];
+		float delta = seconds * (c->regeneration[base + i]
+					 - c->damageOverTime[base + i]);
+		float next = health + delta;
+		float cap = health > max ? health : max;
+
+		next = next < cap ? next : cap;
+		next = next > 0.0f ? next : 0.0f;
+		c->healths[base + i] = next;
+
+		died |= (u32)(next <= 0.0f) << i;
+	}
+
+	return died;
+}
+#endif
+
+size_t effectsTickChunk(
+	struct EntityComponents *components,
+	u16 chunk,
+	float seconds,
+	EntityIdx newlyDead[ENTITY_CHUNK_SIZE]
+)
+{
+	assert(components != NULL);
+	assert(chunk < components->chunkCount);
+	assert(newlyDead != NULL);
+
+	struct EntityChunk *c = components->chunks[chunk];
+	size_t first = (size_t)chunk * ENTITY_CHUNK_SIZE;
+	size_t count = 0;
+
+	for (size_t base = 0; base < ENTITY_CHUNK_SIZE; base += EFFECTS_BLOCK) {
+		u32 died = tickBlock(c, base, seconds);
+
+		while (died != 0) {
+			newlyDead[count++] = (EntityIdx)(first + base
+				+ (size_t)simdLowestBit(died));
+			died &= died - 1;
+		}
+	}
+
+	return count;
+}
+
+size_t effectsTick(
+	struct EntityComponents *components,
+	float seconds,
+	EntityIdx *newlyDead
+)
+{
+	assert(components != NULL);
+
+	size_t count = 0;
+
+	for (u16 chunk = 0; chunk < components->chunkCount; chunk++) {
+		count += effectsTickChunk(components, chunk, seconds,
+					  newlyDead + count);
+	}
+
+	return count;
+}
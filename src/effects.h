@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "common.h"
+#include "entity.h"
+
+/* Status effects tick. Over `seconds`, every living entity (health above 0)
+ * loses `damageOverTime` and gains `regeneration` health per second.
+ * Regeneration stops at `maxHealths`, health already above it is kept, and
+ * health never drops below 0. Dead entities are left untouched, including
+ * empty slots and those freed by `entityDespawn()`.
+ *
+ * The entities that died during this tick are written to `newlyDead`, which
+ * has room for every entity of `components`, and their count is returned.
+ * Chunks are processed 8 or 4 entities at a time with AVX2 or SSE2 when the
+ * compiler targets them, one at a time otherwise. */
+size_t effectsTick(
+	struct EntityComponents *components,
+	float seconds,
+	EntityIdx *newlyDead
+);
+/* The part of `effectsTick()` over one chunk, chunks can be ticked in
+ * parallel */
+size_t effectsTickChunk(
+	struct EntityComponents *components,
+	u16 chunk,
+	float seconds,
+	EntityIdx newlyDead[ENTITY_CHUNK_SIZE]
+);
@@ -0,0 +1,189 @@
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+
+#include "entity.h"
+
+_Static_assert(1ull << sizeof(EntityIdx) * CHAR_BIT >= MAX_ENTITIES,
+	       "EntityIdx's type cannot address all values of MAX_ENTITIES");
+_Static_assert(MAX_ENTITIES % ENTITY_CHUNK_SIZE == 0,
+	       "MAX_ENTITIES must be a multiple of ENTITY_CHUNK_SIZE");
+
+/* Cache line, and wide enough for AVX-512 loads */
+#define ENTITY_CHUNK_ALIGNMENT 64
+
+#define ENTITY_ID(entity, generation) \
+	((EntityId)(entity) | (EntityId)(generation) << 16)
+
+void entityComponentsInit(struct EntityComponents *components)
+{
+	assert(components != NULL);
+
+	memset(components, 0, sizeof(struct EntityComponents));
+}
+
+void entityComponentsReserve(
+	struct EntityComponents *components,
+	size_t entityCount
+)
+{
+	assert(components != NULL);
+	assert(entityCount <= MAX_ENTITIES);
+	assert(ownsWorldMemory());
+
+	while ((size_t)components->chunkCount * ENTITY_CHUNK_SIZE < entityCount) {
+		struct EntityChunk *chunk = largeArenaAlloc(
+			sizeof(struct EntityChunk), ENTITY_CHUNK_ALIGNMENT);
+		memset(chunk, 0, sizeof(struct EntityChunk));
+
+		struct EntityColdChunk *coldChunk = sharedArenaAlloc(
+			sizeof(struct EntityColdChunk),
+			_Alignof(struct EntityColdChunk));
+		memset(coldChunk, 0, sizeof(struct EntityColdChunk));
+
+		components->chunks[components->chunkCount] = chunk;
+		components->coldChunks[components->chunkCount] = coldChunk;
+		components->chunkCount += 1;
+	}
+}
+
+void entityAllocatorInit(struct EntityAllocator *allocator)
+{
+	assert(allocator != NULL);
+
+	memset(allocator, 0, sizeof(struct EntityAllocator));
+
+	/* Entity 0 is the null entity, it is never handed out */
+	for (EntityIdx i = 1; i < MAX_ENTITIES - 1; i++) {
+		allocator->nextFree[i] = i + 1;
+	}
+
+	allocator->freeListHead = 1;
+}
+
+EntityId entityCreate(struct EntityAllocator *allocator)
+{
+	assert(allocator != NULL);
+
+	/* Indicates every slot is in use */
+	if (allocator->freeListHead == 0) {
+		return ENTITY_ID_NONE;
+	}
+
+	EntityIdx entity = allocator->freeListHead;
+	allocator->freeListHead = allocator->nextFree[entity];
+	allocator->nextFree[entity] = 0;
+
+	allocator->denseIndex[entity] = allocator->count;
+	allocator->dense[allocator->count] = entity;
+	allocator->count += 1;
+
+	return ENTITY_ID(entity, allocator->generation[entity]);
+}
+
+bool entityDestroy(struct EntityAllocator *allocator, EntityId id)
+{
+	assert(allocator != NULL);
+
+	if (!entityIsAlive(allocator, id)) {
+		return false;
+	}
+
+	EntityIdx entity = ENTITY_ID_INDEX(id);
+
+	/* Fill the hole with the last live entity to keep `dense` packed */
+	u16 hole = allocator->denseIndex[entity];
+	EntityIdx last = allocator->dense[allocator->count - 1];
+	allocator->dense[hole] = last;
+	allocator->denseIndex[last] = hole;
+	allocator->count -= 1;
+
+	allocator->generation[entity] += 1;
+	allocator->nextFree[entity] = allocator->freeListHead;
+	allocator->freeListHead = entity;
+
+	return true;
+}
+
+bool entityIsAlive(const struct EntityAllocator *allocator, EntityId id)
+{
+	assert(allocator != NULL);
+
+	EntityIdx entity = ENTITY_ID_INDEX(id);
+	if (entity == 0) {
+		return false;
+	}
+
+	if (allocator->generation[entity] != ENTITY_ID_GENERATION(id)) {
+		return false;
+	}
+
+	/* A free slot still has the generation of its next owner */
+	u16 position = allocator->denseIndex[entity];
+	return position < allocator->count
+		&& allocator->dense[position] == entity;
+}
+
+EntityId entityGetId(const struct EntityAllocator *allocator, EntityIdx entity)
+{
+	assert(allocator != NULL);
+	assert(entity > 0);
+
+	return ENTITY_ID(entity, allocator->generation[entity]);
+}
+
+EntityId entitySpawn(
+	struct EntityAllocator *allocator,
+	struct EntityComponents *components
+)
+{
+	assert(allocator != NULL);
+	assert(components != NULL);
+
+	EntityId id = entityCreate(allocator);
+	if (id == ENTITY_ID_NONE) {
+		return ENTITY_ID_NONE;
+	}
+
+	EntityIdx entity = ENTITY_ID_INDEX(id);
+	entityComponentsReserve(components, (size_t)entity + 1);
+
+	/* The slot may hold the columns of a destroyed entity */
+	ENTITY_COLD(components, names, entity) = SYMBOL_NONE;
+	ENTITY_COLD(components, description, entity) = SYMBOL_NONE;
+	ENTITY(components, healths, entity) = 0.0f;
+	ENTITY(components, maxHealths, entity) = 0.0f;
+	ENTITY(components, damageOverTime, entity) = 0.0f;
+	ENTITY(components, regeneration, entity) = 0.0f;
+	ENTITY(components, types, entity) = TYPE_NONE;
+
+	/* Clearing the location here would leave the slot linked in its old
+	 * room's list, the last owner must have left it, see worldDespawn() */
+	assert(ENTITY(components, location, entity) == 0);
+
+	return id;
+}
+
+bool entityDespawn(
+	struct EntityAllocator *allocator,
+	struct EntityComponents *components,
+	EntityId id
+)
+{
+	assert(allocator != NULL);
+	assert(components != NULL);
+
+	if (!entityDestroy(allocator, id)) {
+		return false;
+	}
+
+	/* A spawned entity's chunk is always reserved */
+	EntityIdx entity = ENTITY_ID_INDEX(id);
+	assert(ENTITY(components, location, entity) == 0);
+	ENTITY(components, healths, entity) = 0.0f;
+	ENTITY(components, damageOverTime, entity) = 0.0f;
+	ENTITY(components, regeneration, entity) = 0.0f;
+	ENTITY(components, types, entity) = TYPE_NONE;
+
+	return true;
+}
@@ -1,13 +1,26 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "common.h"
+#include "intern.h"
 
-#define MAX_ENTITIES MAX_DEFAULT
+/* Entity columns are stored in chunks of ENTITY_CHUNK_SIZE entities, added as
+ * the world grows, up to every entity EntityIdx can address */
+#define ENTITY_CHUNK_SIZE MAX_DEFAULT
+#define MAX_ENTITIES (1 << 16)
+#define MAX_ENTITY_CHUNKS (MAX_ENTITIES / ENTITY_CHUNK_SIZE)
 
 typedef u16 EntityIdx;
 typedef u8 EntityType;
+/* Reference to an entity that detects reuse of its slot: the EntityIdx in the
+ * low 16 bits, the slot's generation in the high 16 bits. 0 is no entity. */
+typedef u32 EntityId;
+
+#define ENTITY_ID_NONE 0
+#define ENTITY_ID_INDEX(id) ((EntityIdx)((id) & 0xFFFF))
+#define ENTITY_ID_GENERATION(id) ((u16)((id) >> 16))
 
 enum {
 	TYPE_NONE = 0,
@@ -43,11 +56,90 @@ _Static_assert((TYPE_BEAST | TYPE_UNDEAD | TYPE_DEMON | TYPE_ELEMENTAL |
                 TYPE_FUNGUS | TYPE_HUMAN | TYPE_KOBOLD | TYPE_CELESTIAL) <= UINT8_MAX,
                "EntityType flags exceed uint8_t range");
 
+/* The hot columns of ENTITY_CHUNK_SIZE consecutive entities, the data per-tick
+ * systems read and write. Chunks are 64-byte aligned for SIMD and independent,
+ * systems may process them in parallel. */
+struct EntityChunk {
+	float healths[ENTITY_CHUNK_SIZE];
+	/* Status effects, per second, see effects.h */
+	float maxHealths[ENTITY_CHUNK_SIZE];
+	float damageOverTime[ENTITY_CHUNK_SIZE];
+	float regeneration[ENTITY_CHUNK_SIZE];
+	EntityIdx location[ENTITY_CHUNK_SIZE];
+	EntityType types[ENTITY_CHUNK_SIZE];
+};
+
+/* Text of the same entities, only read when describing them to the player */
+struct EntityColdChunk {
+	Symbol names[ENTITY_CHUNK_SIZE];
+	Symbol description[ENTITY_CHUNK_SIZE];
+};
+
 struct EntityComponents {
 	/* Entity 0 is special, it's the null entity */
-	char *names[MAX_ENTITIES];
-	char *description[MAX_ENTITIES];
-	float healths[MAX_ENTITIES];
-	EntityIdx location[MAX_ENTITIES];
-	EntityType types[MAX_ENTITIES];
+	struct EntityChunk *chunks[MAX_ENTITY_CHUNKS];
+	struct EntityColdChunk *coldChunks[MAX_ENTITY_CHUNKS];
+	u16 chunkCount;
 };
+
+/* Column `column` of `entity`, e.g. ENTITY(components, healths, e) -= 1.0f.
+ * The entity's chunk must have been reserved. */
+#define ENTITY(components, column, entity)\
+	((components)->chunks[(entity) / ENTITY_CHUNK_SIZE]\
+		->column[(entity) % ENTITY_CHUNK_SIZE])
+/* Same for the columns of `struct EntityColdChunk` */
+#define ENTITY_COLD(components, column, entity)\
+	((components)->coldChunks[(entity) / ENTITY_CHUNK_SIZE]\
+		->column[(entity) % ENTITY_CHUNK_SIZE])
+
+/* Hands out entity slots. Live entities are packed at the front of `dense` in
+ * no particular order, so systems iterate `dense[0..count)` without testing
+ * for dead slots. Dead slots are chained in a free list through `nextFree`,
+ * destroying an entity bumps its slot's generation so old EntityIds go
+ * stale. */
+struct EntityAllocator {
+	u16 generation[MAX_ENTITIES];
+	EntityIdx nextFree[MAX_ENTITIES];
+	EntityIdx freeListHead;
+
+	EntityIdx dense[MAX_ENTITIES];
+	/* Position of each live entity in `dense` */
+	u16 denseIndex[MAX_ENTITIES];
+	u16 count;
+};
+
+void entityComponentsInit(struct EntityComponents *components);
+/* Add chunks until `entityCount` entities fit. Chunks are zeroed and live
+ * until `cleanupArena()`. Hot chunks come from the large arena, cold chunks
+ * from the shared arena, away from the hot ones. Only the thread owning the
+ * world's memory may grow them, see `claimWorldMemory()`. */
+void entityComponentsReserve(
+	struct EntityComponents *components,
+	size_t entityCount
+);
+
+void entityAllocatorInit(struct EntityAllocator *allocator);
+/* Return ENTITY_ID_NONE when every slot is in use. The caller initializes the
+ * entity's components. */
+EntityId entityCreate(struct EntityAllocator *allocator);
+/* Return whether the entity was alive and is now destroyed */
+bool entityDestroy(struct EntityAllocator *allocator, EntityId id);
+bool entityIsAlive(const struct EntityAllocator *allocator, EntityId id);
+/* EntityId of the live entity in slot `entity` */
+EntityId entityGetId(const struct EntityAllocator *allocator, EntityIdx entity);
+/* `entityCreate()`, then reserve the entity's chunk and zero its columns. The
+ * entity is in no room. Game code spawns through `worldSpawn()`, which also
+ * keeps the location index in sync. */
+EntityId entitySpawn(
+	struct EntityAllocator *allocator,
+	struct EntityComponents *components
+);
+/* `entityDestroy()`, then clear the entity's health, status effects and types
+ * so per-tick systems and queries, which test the columns rather than the
+ * allocator, leave its slot alone. The entity must have left its room first,
+ * as `worldDespawn()` does. */
+bool entityDespawn(
+	struct EntityAllocator *allocator,
+	struct EntityComponents *components,
+	EntityId id
+);
@@ -4,6 +4,9 @@ typedef enum Error {
 	ERR_OK = 0,
 	ERR_RESOURCE_LOADING_FAILED,
 	ERR_OUT_OF_MEMORY,
+	ERR_THREAD_CREATION_FAILED,
+	ERR_FILE_WRITING_FAILED,
+	ERR_FILE_READING_FAILED,
 } Error;
 
 static inline const char *errorToString(Error err)
@@ -12,6 +15,9 @@ static inline const char *errorToString(Error err)
 	case ERR_OK: return "ok";
 	case ERR_RESOURCE_LOADING_FAILED: return "resource loading failed";
 	case ERR_OUT_OF_MEMORY: return "out of memory";
+	case ERR_THREAD_CREATION_FAILED: return "thread creation failed";
+	case ERR_FILE_WRITING_FAILED: return "file writing failed";
+	case ERR_FILE_READING_FAILED: return "file reading failed";
 	default: return "unknown";
 	}
 }
@@ -0,0 +1,37 @@
+#include <assert.h>
+#include <string.h>
+
+#include "../memstats.h"
+
+#define HASHMAP_MALLOC(s) (memTrackedRealloc(MEM_TAG_HASHMAP, NULL, (s)))
+#define HASHMAP_FREE(p) (memTrackedFree(MEM_TAG_HASHMAP, (p)))
+
+#include "hashmap.h"
+
+u64 hashString(const char *str)
+{
+	assert(str != NULL);
+
+	return fnv1a_64_str(str);
+}
+
+bool equalString(const char *a, const char *b)
+{
+	return a == b || strcmp(a, b) == 0;
+}
+
+u64 hashU32(u32 key)
+{
+	/* Fibonacci hashing spreads sequential IDs over the high bits, which
+	 * select the group */
+	u64 hash = (u64)key * 0x9E3779B97F4A7C15ULL;
+	return hash ^ (hash >> 32);
+}
+
+bool equalU32(u32 a, u32 b)
+{
+	return a == b;
+}
+
+HASHMAP_DEFINE(StringMap, string_map, const char*, u32, hashString, equalString)
+HASHMAP_DEFINE(U32Map, u32_map, u32, u32, hashU32, equalU32)
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "../laz_utils.h"
+#include "hashmap_base.h"
+
+u64 hashString(const char *str);
+bool equalString(const char *a, const char *b);
+u64 hashU32(u32 key);
+bool equalU32(u32 a, u32 b);
+
+/* Name-to-entity, name-to-room and command verb lookups. Strings are borrowed,
+ * they must outlive the map. */
+HASHMAP_DECLARE(StringMap, string_map, const char*, u32)
+HASHMAP_DECLARE(U32Map, u32_map, u32, u32)
@@ -0,0 +1,447 @@
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Library to generate type-safe open-addressing hash maps.
+ *
+ * To generate hash maps, use the macros HASHMAP_DECLARE() to generate the
+ * header, and HASHMAP_DEFINE() to generate the source, the same way as
+ * VECTOR_DECLARE() and VECTOR_DEFINE() from vector_base.h. HASHMAP_DEFINE()
+ * also takes the hash function `uint64_t hash(Key)` and the equality function
+ * `bool equal(Key, Key)`.
+ *
+ * The table follows the SwissTable layout: every slot has a control byte that
+ * is either empty, deleted (tombstone), or holds the low 7 bits of the key's
+ * hash. Slots are probed 16 at a time: a group of control bytes is compared
+ * against the hash's 7 bits in one SSE2 instruction (scalar fallback when SSE2
+ * is not available), so most lookups compare a single key. The high bits of the
+ * hash select the first group, and groups are probed quadratically. The table
+ * holds at most 7/8 of its capacity, then doubles.
+ *
+ * Keys and values are stored by value, so a map of strings does not own its
+ * strings.
+ *
+ * This library is not thread safe.
+ *
+ * Configuration options:
+ *
+ * - HASHMAP_MALLOC (default malloc(3)): specify the allocator. If using a
+ *   custom allocator, must also specify HASHMAP_FREE. The arena can be used by
+ *   defining HASHMAP_FREE as a no-op.
+ *
+ * - HASHMAP_FREE (default free(3)): specify the deallocator. If using a custom
+ *   deallocator, must also specify HASHMAP_MALLOC.
+ *
+ *
+ * API Functions:
+ *
+ * The following documentation takes this generated hash map for instance:
+ * HASHMAP_DECLARE(Map, map, Key, Value)
+ *
+ * void map_init(Map *map)
+ *   Initialize an empty map. Optional if the map's memory is zero-ed out.
+ *
+ * void map_free(Map *map)
+ *   Deallocate the map's memory. Safe to call on already-freed maps.
+ *
+ * void map_reserve(Map *map, size_t count)
+ *   Grow so that `count` entries fit without rehashing.
+ *
+ * bool map_put(Map *map, Key key, Value value)
+ *   Insert or overwrite. Return true if the key was not in the map.
+ *
+ * Value *map_get(const Map *map, Key key)
+ *   Return a pointer to the value, or NULL if missing. The pointer is
+ *   invalidated by the next insertion.
+ *
+ * bool map_has(const Map *map, Key key)
+ *   Return whether the key is in the map.
+ *
+ * bool map_remove(Map *map, Key key)
+ *   Return whether the key was found and removed.
+ *
+ * void map_clear(Map *map)
+ *   Remove all entries without deallocating capacity.
+ *
+ * bool map_next(const Map *map, size_t *cursor, Key *key, Value **value)
+ *   Iterate over entries in unspecified order. Start with `*cursor = 0`, return
+ *   false once every entry has been visited.
+ *
+ *
+ * Example:
+ *  HASHMAP_DECLARE(Ages, ages, const char*, int)
+ *  HASHMAP_DEFINE(Ages, ages, const char*, int, hashString, equalString)
+ *
+ *  Ages map = {0};
+ *  ages_put(&map, "Jerry", 27);
+ *  int *age = ages_get(&map, "Jerry");
+ *  ages_free(&map);
+ */
+
+#if defined(HASHMAP_MALLOC) && !defined(HASHMAP_FREE) || \
+	!defined(HASHMAP_MALLOC) && defined(HASHMAP_FREE)
+#error "You must define both HASHMAP_MALLOC and HASHMAP_FREE, or neither."
+#endif
+#if !defined(HASHMAP_MALLOC) && !defined(HASHMAP_FREE)
+#define HASHMAP_MALLOC(s) (malloc((s)))
+#define HASHMAP_FREE(p) (free((p)))
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) \
+	|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASHMAP_SSE2 1
+#include <emmintrin.h>
+#else
+#define HASHMAP_SSE2 0
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+enum {
+	HASHMAP_GROUP_WIDTH = 16,
+	HASHMAP_CTRL_EMPTY = 0x80,
+	HASHMAP_CTRL_DELETED = 0xFE,
+};
+
+#define HASHMAP_H1(hash) ((hash) >> 7)
+#define HASHMAP_H2(hash) ((uint8_t)((hash) & 0x7F))
+
+/* Bit i is set when control byte i of the group equals `byte` */
+static inline uint32_t hashmap_group_match(const uint8_t *group, uint8_t byte)
+{
+#if HASHMAP_SSE2
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	__m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)byte));
+	return (uint32_t)_mm_movemask_epi8(match);
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < HASHMAP_GROUP_WIDTH; i++) {
+		mask |= (uint32_t)(group[i] == byte) << i;
+	}
+	return mask;
+#endif
+}
+
+/* Bit i is set when slot i of the group is empty or deleted */
+static inline uint32_t hashmap_group_match_free(const uint8_t *group)
+{
+#if HASHMAP_SSE2
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+	return (uint32_t)_mm_movemask_epi8(ctrl);
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < HASHMAP_GROUP_WIDTH; i++) {
+		mask |= (uint32_t)(group[i] >> 7) << i;
+	}
+	return mask;
+#endif
+}
+
+static inline int hashmap_ctz(uint32_t mask)
+{
+	assert(mask != 0);
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	int count = 0;
+	while ((mask & 1u) == 0) {
+		mask >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+static inline size_t hashmap_align(size_t size)
+{
+	return (size + HASHMAP_GROUP_WIDTH - 1) & ~(size_t)(HASHMAP_GROUP_WIDTH - 1);
+}
+
+#define HASHMAP_DECLARE(Struct_Name_, Functions_Prefix_, Key_Type_, Value_Type_)\
+\
+typedef struct Struct_Name_ {\
+	uint8_t *ctrl;\
+	Key_Type_ *keys;\
+	Value_Type_ *values;\
+	/* Power of two, multiple of HASHMAP_GROUP_WIDTH, or 0 */\
+	size_t capacity;\
+	size_t size;\
+	/* Empty slots that can be filled before rehashing */\
+	size_t growthLeft;\
+} Struct_Name_;\
+\
+void Functions_Prefix_##_init(Struct_Name_ *map);\
+void Functions_Prefix_##_free(Struct_Name_ *map);\
+void Functions_Prefix_##_reserve(Struct_Name_ *map, size_t count);\
+bool Functions_Prefix_##_put(Struct_Name_ *map, Key_Type_ key, Value_Type_ value);\
+Value_Type_ *Functions_Prefix_##_get(const Struct_Name_ *map, Key_Type_ key);\
+bool Functions_Prefix_##_has(const Struct_Name_ *map, Key_Type_ key);\
+bool Functions_Prefix_##_remove(Struct_Name_ *map, Key_Type_ key);\
+void Functions_Prefix_##_clear(Struct_Name_ *map);\
+bool Functions_Prefix_##_next(const Struct_Name_ *map, size_t *cursor, Key_Type_ *key, Value_Type_ **value);
+
+#define HASHMAP_DEFINE(Struct_Name_, Functions_Prefix_, Key_Type_, Value_Type_, Hash_Function_, Equal_Function_)\
+\
+void Functions_Prefix_##_init(Struct_Name_ *map)\
+{\
+	assert(map != NULL);\
+\
+	memset(map, 0, sizeof(Struct_Name_));\
+}\
+\
+void Functions_Prefix_##_free(Struct_Name_ *map)\
+{\
+	assert(map != NULL);\
+\
+	if (map->ctrl != NULL) {\
+		HASHMAP_FREE(map->ctrl);\
+	}\
+	Functions_Prefix_##_init(map);\
+}\
+\
+/* Return the slot holding the key, or capacity if missing */\
+static size_t Functions_Prefix_##_find(const Struct_Name_ *map, Key_Type_ key, uint64_t hash)\
+{\
+	if (map->capacity == 0) {\
+		return 0;\
+	}\
+\
+	size_t groupMask = map->capacity / HASHMAP_GROUP_WIDTH - 1;\
+	size_t group = HASHMAP_H1(hash) & groupMask;\
+	uint8_t h2 = HASHMAP_H2(hash);\
+\
+	for (size_t probe = 1; probe <= groupMask + 1; probe++) {\
+		const uint8_t *ctrl = map->ctrl + group * HASHMAP_GROUP_WIDTH;\
+\
+		for (uint32_t match = hashmap_group_match(ctrl, h2); match != 0;\
+		     match &= match - 1) {\
+			size_t slot = group * HASHMAP_GROUP_WIDTH\
+				+ (size_t)hashmap_ctz(match);\
+			if (Equal_Function_(map->keys[slot], key)) {\
+				return slot;\
+			}\
+		}\
+\
+		/* An empty slot ends every probe sequence passing through */\
+		if (hashmap_group_match(ctrl, HASHMAP_CTRL_EMPTY) != 0) {\
+			break;\
+		}\
+\
+		group = (group + probe) & groupMask;\
+	}\
+\
+	return map->capacity;\
+}\
+\
+/* Return the first empty or deleted slot of the hash's probe sequence */\
+static size_t Functions_Prefix_##_find_free(const Struct_Name_ *map, uint64_t hash)\
+{\
+	size_t groupMask = map->capacity / HASHMAP_GROUP_WIDTH - 1;\
+	size_t group = HASHMAP_H1(hash) & groupMask;\
+\
+	for (size_t probe = 1;; probe++) {\
+		uint32_t match = hashmap_group_match_free(\
+			map->ctrl + group * HASHMAP_GROUP_WIDTH);\
+		if (match != 0) {\
+			return group * HASHMAP_GROUP_WIDTH\
+				+ (size_t)hashmap_ctz(match);\
+		}\
+		assert(probe <= groupMask + 1);\
+		group = (group + probe) & groupMask;\
+	}\
+}\
+\
+static void Functions_Prefix_##_rehash(Struct_Name_ *map, size_t capacity)\
+{\
+	Struct_Name_ old = *map;\
+	size_t keysOffset = hashmap_align(capacity);\
+	size_t valuesOffset = keysOffset\
+		+ hashmap_align(capacity * sizeof(Key_Type_));\
+	size_t totalSize = valuesOffset + capacity * sizeof(Value_Type_);\
+\
+	if (capacity > ((size_t)-1) / (sizeof(Key_Type_) + sizeof(Value_Type_) + 1)) {\
+		(void)fprintf(stderr, "Requested capacity would cause size overflow.\n");\
+		abort();\
+	}\
+\
+	uint8_t *memory = HASHMAP_MALLOC(totalSize);\
+	if (memory == NULL) {\
+		(void)fprintf(stderr, "Out of memory. Panic.\n");\
+		abort();\
+	}\
+\
+	memset(memory, HASHMAP_CTRL_EMPTY, capacity);\
+	map->ctrl = memory;\
+	map->keys = (Key_Type_ *)(void *)(memory + keysOffset);\
+	map->values = (Value_Type_ *)(void *)(memory + valuesOffset);\
+	map->capacity = capacity;\
+	map->growthLeft = capacity - capacity / 8 - old.size;\
+\
+	for (size_t i = 0; i < old.capacity; i++) {\
+		if (old.ctrl[i] & 0x80) {\
+			continue;\
+		}\
+\
+		uint64_t hash = Hash_Function_(old.keys[i]);\
+		size_t slot = Functions_Prefix_##_find_free(map, hash);\
+		map->ctrl[slot] = HASHMAP_H2(hash);\
+		map->keys[slot] = old.keys[i];\
+		map->values[slot] = old.values[i];\
+	}\
+\
+	if (old.ctrl != NULL) {\
+		HASHMAP_FREE(old.ctrl);\
+	}\
+}\
+\
+void Functions_Prefix_##_reserve(Struct_Name_ *map, size_t count)\
+{\
+	assert(map != NULL);\
+\
+	size_t capacity = map->capacity ? map->capacity : HASHMAP_GROUP_WIDTH;\
+	while (capacity - capacity / 8 < count) {\
+		capacity *= 2;\
+	}\
+\
+	if (capacity > map->capacity) {\
+		Functions_Prefix_##_rehash(map, capacity);\
+	}\
+}\
+\
+bool Functions_Prefix_##_put(Struct_Name_ *map, Key_Type_ key, Value_Type_ value)\
+{\
+	assert(map != NULL);\
+\
+	uint64_t hash = Hash_Function_(key);\
+	size_t slot = Functions_Prefix_##_find(map, key, hash);\
+\
+	if (slot < map->capacity) {\
+		map->values[slot] = value;\
+		return false;\
+	}\
+\
+	if (map->growthLeft == 0) {\
+		/* Mostly tombstones: clean up in place instead of growing */\
+		size_t capacity = map->capacity;\
+		if (capacity == 0 || map->size >= capacity / 2) {\
+			capacity = capacity ? capacity * 2 : HASHMAP_GROUP_WIDTH;\
+		}\
+		Functions_Prefix_##_rehash(map, capacity);\
+	}\
+\
+	slot = Functions_Prefix_##_find_free(map, hash);\
+	if (map->ctrl[slot] == HASHMAP_CTRL_EMPTY) {\
+		map->growthLeft--;\
+	}\
+	map->ctrl[slot] = HASHMAP_H2(hash);\
+	map->keys[slot] = key;\
+	map->values[slot] = value;\
+	map->size++;\
+\
+	return true;\
+}\
+\
+Value_Type_ *Functions_Prefix_##_get(const Struct_Name_ *map, Key_Type_ key)\
+{\
+	assert(map != NULL);\
+\
+	size_t slot = Functions_Prefix_##_find(map, key, Hash_Function_(key));\
+	if (slot >= map->capacity) {\
+		return NULL;\
+	}\
+\
+	return &map->values[slot];\
+}\
+\
+bool Functions_Prefix_##_has(const Struct_Name_ *map, Key_Type_ key)\
+{\
+	return Functions_Prefix_##_get(map, key) != NULL;\
+}\
+\
+bool Functions_Prefix_##_remove(Struct_Name_ *map, Key_Type_ key)\
+{\
+	assert(map != NULL);\
+\
+	size_t slot = Functions_Prefix_##_find(map, key, Hash_Function_(key));\
+	if (slot >= map->capacity) {\
+		return false;\
+	}\
+\
+	/* Probe sequences stop at groups with an empty slot, so this slot can\
+	 * become empty again. Otherwise a later key may probe past it. */\
+	const uint8_t *group = map->ctrl + slot / HASHMAP_GROUP_WIDTH * HASHMAP_GROUP_WIDTH;\
+	if (hashmap_group_match(group, HASHMAP_CTRL_EMPTY) != 0) {\
+		map->ctrl[slot] = HASHMAP_CTRL_EMPTY;\
+		map->growthLeft++;\
+	} else {\
+		map->ctrl[slot] = HASHMAP_CTRL_DELETED;\
+	}\
+	map->size--;\
+\
+	return true;\
+}\
+\
+void Functions_Prefix_##_clear(Struct_Name_ *map)\
+{\
+	assert(map != NULL);\
+\
+	if (map->capacity == 0) {\
+		return;\
+	}\
+\
+	memset(map->ctrl, HASHMAP_CTRL_EMPTY, map->capacity);\
+	map->size = 0;\
+	map->growthLeft = map->capacity - map->capacity / 8;\
+}\
+\
+bool Functions_Prefix_##_next(const Struct_Name_ *map, size_t *cursor, Key_Type_ *key, Value_Type_ **value)\
+{\
+	assert(map != NULL);\
+	assert(cursor != NULL);\
+\
+	for (; *cursor < map->capacity; (*cursor)++) {\
+		if (map->ctrl[*cursor] & 0x80) {\
+			continue;\
+		}\
+\
+		if (key != NULL) {\
+			*key = map->keys[*cursor];\
+		}\
+		if (value != NULL) {\
+			*value = &map->values[*cursor];\
+		}\
+		(*cursor)++;\
+		return true;\
+	}\
+\
+	return false;\
+}
+
+/****************************************************************************
+ * Copyright (C) 2026 by Roland Marchand <roland.marchand@protonmail.com>   *
+ *                                                                          *
+ * Permission to use, copy, modify, and/or distribute this software for any *
+ * purpose with or without fee is hereby granted.                           *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED “AS IS” AND THE AUTHOR DISCLAIMS ALL WARRANTIES *
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR  *
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES   *
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN    *
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF  *
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.           *
+ ****************************************************************************/
+
+#endif /* HASHMAP_H */
@@ -0,0 +1,70 @@
+#include <assert.h>
+
+#include "intern.h"
+#include "hashmap/hashmap.h"
+#include "list/list.h"
+
+/* Keys point to the shared arena copies in `strings` */
+static StringMap symbols;
+/* Symbol to string, index 0 is SYMBOL_NONE */
+static ListString strings;
+
+Error initIntern(void)
+{
+	string_map_init(&symbols);
+	list_string_init(&strings, VECTOR_DEFAULT_CAPACITY);
+	list_string_push(&strings, "");
+
+	return ERR_OK;
+}
+
+Error cleanupIntern(void)
+{
+	/* The strings themselves are freed along with the shared arena */
+	string_map_free(&symbols);
+	list_string_free(&strings);
+
+	return ERR_OK;
+}
+
+Symbol intern(const char *str)
+{
+	assert(str != NULL);
+	assert(VECTOR_SIZE(&strings) > 0);
+	assert(ownsWorldMemory());
+
+	Symbol *found = string_map_get(&symbols, str);
+	if (found != NULL) {
+		return *found;
+	}
+
+	assert(VECTOR_SIZE(&strings) < UINT32_MAX);
+
+	Symbol symbol = (Symbol)VECTOR_SIZE(&strings);
+	/* Not the thread arena, symbols outlive the tick interning them */
+	char *copy = sharedDuplicateString(str);
+
+	list_string_push(&strings, copy);
+	string_map_put(&symbols, copy, symbol);
+
+	return symbol;
+}
+
+Symbol internFind(const char *str)
+{
+	assert(str != NULL);
+
+	Symbol *found = string_map_get(&symbols, str);
+
+	return found != NULL ? *found : SYMBOL_NONE;
+}
+
+const char *symbolString(Symbol symbol)
+{
+	return list_string_get(&strings, symbol);
+}
+
+u32 internCount(void)
+{
+	return (u32)VECTOR_SIZE(&strings) - 1;
+}
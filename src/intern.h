@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common.h"
+
+/* Interned strings are compared by symbol instead of strcmp(). Every distinct
+ * string is copied once in the shared arena and lives until `cleanupIntern()`.
+ * Only the thread owning the world's memory interns, see `claimWorldMemory()`. */
+typedef u32 Symbol;
+
+/* Never returned by `intern()`, maps to the empty string */
+#define SYMBOL_NONE ((Symbol)0)
+
+/* Call after `initArena()` */
+Error initIntern(void);
+/* Call before `cleanupArena()`, every symbol becomes invalid */
+Error cleanupIntern(void);
+/* Return the symbol of the string, copying it on first sight */
+Symbol intern(const char *str);
+/* Return the symbol of an already interned string, or SYMBOL_NONE */
+Symbol internFind(const char *str);
+/* Return the interned copy of the symbol's string */
+const char *symbolString(Symbol symbol);
+/* Number of distinct strings interned */
+u32 internCount(void);
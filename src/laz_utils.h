@@ -64,9 +64,108 @@ typedef int64_t i64;
 
 /* C11+ only stuff */
 #if __STDC_VERSION__ >= 201112L
+/* Monotonic clock, unaffected by wall clock adjustments. Only the difference
+ * between two readings is meaningful. */
 u64 get_nanoseconds(void);
+/* Cheapest monotonic counter: the time-stamp counter on x86, nanoseconds
+ * elsewhere. `ticks_to_nanoseconds()` converts to the `get_nanoseconds()`
+ * clock, calibrating against it since `laz_trace_init()`, which must have
+ * been called first. */
+u64 get_ticks(void);
+u64 ticks_to_nanoseconds(u64 ticks);
+/* Anchor the tick calibration, waiting a millisecond to have a first measure.
+ * Call it once at startup, before other threads read the clocks. */
+void laz_trace_init(void);
+
+/* Span tracing. A span is a named interval on one thread, recorded in ticks
+ * into the thread's own ring buffer of LAZ_TRACE_BUFFER_SPANS spans, without
+ * locks. When the buffer is full, the oldest spans are overwritten. Define
+ * LAZ_TRACE_DISABLED to compile tracing out, `laz_trace_set_enabled()` turns
+ * it on and off at run time, it starts off.
+ *
+ *	void update(void)
+ *	{
+ *		LAZ_TRACE_SCOPE("update");
+ *		...
+ *	}
+ *
+ * or, without GCC's cleanup attribute:
+ *
+ *	u64 start = laz_trace_begin();
+ *	...
+ *	laz_trace_end("update", start);
+ *
+ * Span names must outlive the trace, typically string literals. */
+#if !defined(__STDC_NO_ATOMICS__) && !defined(LAZ_TRACE_DISABLED)
+#define LAZ_HAVE_TRACE
 #endif
 
+#ifndef LAZ_TRACE_BUFFER_SPANS
+#define LAZ_TRACE_BUFFER_SPANS 4096
+#endif
+
+struct laz_span {
+	const char *name;
+	/* In `get_nanoseconds()` time once passed to a `laz_span_fn` */
+	u64 start;
+	u64 end;
+};
+
+/* `thread` numbers the threads in the order they first traced, from 1 */
+typedef void (*laz_span_fn)(const struct laz_span *span, u32 thread, void *ctx);
+
+#ifdef LAZ_HAVE_TRACE
+/* Free every thread's buffer, once no other thread traces anymore */
+void laz_trace_cleanup(void);
+void laz_trace_set_enabled(int enabled);
+/* 0 when tracing is off, `laz_trace_end()` then records nothing */
+u64 laz_trace_begin(void);
+void laz_trace_end(const char *name, u64 start);
+/* Call `fn` on every span kept, thread by thread, oldest first. A full buffer
+ * keeps its LAZ_TRACE_BUFFER_SPANS - 1 latest spans, the oldest slot being
+ * the next one overwritten. Threads may keep tracing, spans overwritten while
+ * being read are skipped. */
+void laz_trace_foreach(laz_span_fn fn, void *ctx);
+#else
+static inline void laz_trace_cleanup(void) {}
+static inline void laz_trace_set_enabled(int enabled) { (void)enabled; }
+static inline u64 laz_trace_begin(void) { return 0; }
+static inline void laz_trace_end(const char *name, u64 start)
+{
+	(void)name;
+	(void)start;
+}
+static inline void laz_trace_foreach(laz_span_fn fn, void *ctx)
+{
+	(void)fn;
+	(void)ctx;
+}
+#endif
+
+#if defined(LAZ_HAVE_TRACE) && (defined(__GNUC__) || defined(__clang__))
+struct laz_trace_scope {
+	const char *name;
+	u64 start;
+};
+
+static inline void laz_trace_scope_end(struct laz_trace_scope *scope)
+{
+	laz_trace_end(scope->name, scope->start);
+}
+
+#define LAZ_CONCAT_(a, b) a##b
+#define LAZ_CONCAT(a, b) LAZ_CONCAT_(a, b)
+/* Trace from here to the end of the enclosing block */
+#define LAZ_TRACE_SCOPE(name)\
+	struct laz_trace_scope LAZ_CONCAT(laz_trace_scope_, __LINE__)\
+	__attribute__((cleanup(laz_trace_scope_end))) = {\
+		(name), laz_trace_begin()\
+	}
+#else
+#define LAZ_TRACE_SCOPE(name) (void)(name)
+#endif
+#endif /* C11 */
+
 int errorf(const char *LAZ_RESTRICT format, ...);
 LAZ_NORETURN void panicf(const char *LAZ_RESTRICT format, ...);
 /* Can only read files <2GiB. Reading files >=2GiB is undefined behavior. When
@@ -89,13 +188,212 @@ void *reallocarray_try(void *ptr, size_t n, size_t size);
 #ifdef LAZ_UTILS_IMPLEMENTATION
 
 #if __STDC_VERSION__ >= 201112L /* >=C11 */
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LAZ_HAVE_RDTSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define LAZ_HAVE_RDTSC
+#endif
+
+#if defined(_WIN32) && !defined(CLOCK_MONOTONIC)
+/* Declared here rather than through <windows.h>, whose names clash with
+ * raylib's */
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(
+	union _LARGE_INTEGER *count);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(
+	union _LARGE_INTEGER *frequency);
+
+u64 get_nanoseconds(void) {
+	/* Both fit a LARGE_INTEGER, and the frequency is fixed at boot */
+	i64 count = 0;
+	i64 frequency = 1;
+	QueryPerformanceCounter((union _LARGE_INTEGER *)&count);
+	QueryPerformanceFrequency((union _LARGE_INTEGER *)&frequency);
+
+	/* Split to not overflow after a few hours at 10 MHz */
+	u64 seconds = (u64)count / (u64)frequency;
+	u64 remainder = (u64)count % (u64)frequency;
+	return seconds * 1000000000ULL + remainder * 1000000000ULL / (u64)frequency;
+}
+#else
 u64 get_nanoseconds(void) {
 	struct timespec ts = LAZ_INIT;
+#if defined(CLOCK_MONOTONIC) /* POSIX */
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#elif defined(TIME_MONOTONIC) /* C23 */
+	timespec_get(&ts, TIME_MONOTONIC);
+#else
 	timespec_get(&ts, TIME_UTC);
+#endif
 	return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
 }
 #endif
 
+#ifdef LAZ_HAVE_RDTSC
+/* Readings of both clocks at `laz_trace_init()` */
+static u64 laz_anchor_ticks;
+static u64 laz_anchor_nanoseconds;
+
+u64 get_ticks(void) {
+	return __rdtsc();
+}
+
+void laz_trace_init(void) {
+	laz_anchor_nanoseconds = get_nanoseconds();
+	laz_anchor_ticks = get_ticks();
+
+	while (get_nanoseconds() - laz_anchor_nanoseconds < 1000000);
+}
+
+/* Nanoseconds per tick, measured since the anchor, over at least the
+ * millisecond `laz_trace_init()` waited. Only reads the anchor, any thread
+ * may call it. */
+static double laz_nanoseconds_per_tick(void) {
+	if (unlikely(laz_anchor_ticks == 0)) {
+		panicf("laz_trace_init() must be called before converting ticks\n");
+	}
+
+	u64 nanoseconds = get_nanoseconds();
+	u64 ticks = get_ticks();
+
+	return (double)(nanoseconds - laz_anchor_nanoseconds) /
+	       (double)(ticks - laz_anchor_ticks);
+}
+
+static u64 laz_convert_ticks(u64 ticks, double nanoseconds_per_tick) {
+	double offset = ((double)ticks - (double)laz_anchor_ticks) *
+			nanoseconds_per_tick;
+	return laz_anchor_nanoseconds + (u64)(i64)offset;
+}
+#else
+void laz_trace_init(void) {}
+
+u64 get_ticks(void) {
+	return get_nanoseconds();
+}
+
+static double laz_nanoseconds_per_tick(void) {
+	return 1.0;
+}
+
+static u64 laz_convert_ticks(u64 ticks, double nanoseconds_per_tick) {
+	(void)nanoseconds_per_tick;
+	return ticks;
+}
+#endif
+
+u64 ticks_to_nanoseconds(u64 ticks) {
+	return laz_convert_ticks(ticks, laz_nanoseconds_per_tick());
+}
+
+#ifdef LAZ_HAVE_TRACE
+#include <stdatomic.h>
+
+/* Written by its thread only, `count` is published after the span */
+struct laz_trace_buffer {
+	struct laz_span spans[LAZ_TRACE_BUFFER_SPANS];
+	atomic_uint_least64_t count;
+	u32 thread;
+	struct laz_trace_buffer *next;
+};
+
+static _Atomic(struct laz_trace_buffer *) laz_trace_buffers;
+static atomic_uint laz_trace_thread_count;
+static atomic_int laz_trace_enabled;
+static _Thread_local struct laz_trace_buffer *laz_trace_local;
+
+void laz_trace_cleanup(void) {
+	struct laz_trace_buffer *buffer = atomic_exchange(&laz_trace_buffers, NULL);
+
+	while (buffer != NULL) {
+		struct laz_trace_buffer *next = buffer->next;
+		free(buffer);
+		buffer = next;
+	}
+
+	laz_trace_local = NULL;
+	atomic_store(&laz_trace_thread_count, 0);
+}
+
+void laz_trace_set_enabled(int enabled) {
+	atomic_store_explicit(&laz_trace_enabled, enabled, memory_order_relaxed);
+}
+
+u64 laz_trace_begin(void) {
+	if (!atomic_load_explicit(&laz_trace_enabled, memory_order_relaxed)) {
+		return 0;
+	}
+
+	return get_ticks();
+}
+
+static struct laz_trace_buffer *laz_trace_register(void) {
+	struct laz_trace_buffer *buffer = calloc_try(1, sizeof(*buffer));
+	buffer->thread = atomic_fetch_add(&laz_trace_thread_count, 1) + 1;
+
+	buffer->next = atomic_load(&laz_trace_buffers);
+	while (!atomic_compare_exchange_weak(&laz_trace_buffers, &buffer->next,
+					     buffer));
+
+	laz_trace_local = buffer;
+	return buffer;
+}
+
+void laz_trace_end(const char *name, u64 start) {
+	if (start == 0) {
+		return;
+	}
+
+	u64 end = get_ticks();
+	struct laz_trace_buffer *buffer = laz_trace_local;
+	if (unlikely(buffer == NULL)) {
+		buffer = laz_trace_register();
+	}
+
+	u64 count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+	struct laz_span *span = &buffer->spans[count % LAZ_TRACE_BUFFER_SPANS];
+	span->name = name;
+	span->start = start;
+	span->end = end;
+	atomic_store_explicit(&buffer->count, count + 1, memory_order_release);
+}
+
+void laz_trace_foreach(laz_span_fn fn, void *ctx) {
+	double nanoseconds_per_tick = laz_nanoseconds_per_tick();
+
+	for (struct laz_trace_buffer *buffer = atomic_load(&laz_trace_buffers);
+	     buffer != NULL; buffer = buffer->next) {
+		u64 count = atomic_load_explicit(&buffer->count,
+						 memory_order_acquire);
+		/* The oldest slot is the next one written */
+		u64 first = count >= LAZ_TRACE_BUFFER_SPANS ?
+			count - (LAZ_TRACE_BUFFER_SPANS - 1) : 0;
+
+		for (u64 i = first; i < count; i++) {
+			struct laz_span span = buffer->spans[i % LAZ_TRACE_BUFFER_SPANS];
+
+			/* The writer may have lapped us while copying */
+			atomic_thread_fence(memory_order_acquire);
+			u64 written = atomic_load_explicit(&buffer->count,
+							   memory_order_relaxed);
+			/* Slot `i` is rewritten from when `count` reads
+			 * `i + LAZ_TRACE_BUFFER_SPANS`, before it is published */
+			if (written - i >= LAZ_TRACE_BUFFER_SPANS) {
+				continue;
+			}
+
+			span.start = laz_convert_ticks(span.start,
+						       nanoseconds_per_tick);
+			span.end = laz_convert_ticks(span.end,
+						     nanoseconds_per_tick);
+			fn(&span, buffer->thread, ctx);
+		}
+	}
+}
+#endif /* LAZ_HAVE_TRACE */
+#endif /* C11 */
+
 int errorf(const char *LAZ_RESTRICT format, ...)
 {
 	va_list args;
@@ -3,79 +3,77 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#include "list.h"
+#include "../memstats.h"
+
+/* Every List/ListString buffer and list pool chunk is allocated in this file */
+#define VECTOR_REALLOC(p, s) (memTrackedRealloc(MEM_TAG_VECTOR, (p), (s)))
+#define VECTOR_FREE(p) (memTrackedFree(MEM_TAG_VECTOR, (p)))
+/* The pool counts list handles, not the chunks behind them */
+#define POOL_REALLOC(p, s) (memTrackedReallocChunk(MEM_TAG_LIST_POOL, (p), (s)))
+#define POOL_FREE(p) (memTrackedFree(MEM_TAG_LIST_POOL, (p)))
 
-#define POOL_SIZE 128
-#define POOL_END ((size_t)-1)
+#include "list.h"
 
 VECTOR_DEFINE(List, list, void*)
 VECTOR_DEFINE(ListString, list_string, char*)
+VECTOR_DEFINE(ListFloat, list_float, float)
 
-typedef struct {
-	List lists[POOL_SIZE];
-	size_t nextFree[POOL_SIZE];
-	bool allocated[POOL_SIZE];
-} Pool;
+POOL_DECLARE(ListPool, list_pool, List)
+POOL_DEFINE(ListPool, list_pool, List)
 
-static Pool listPool;
-static size_t freeListPoolHead = 0;
+static ListPool listPool;
 
 void initListPool(void) {
-	for (size_t i = 0; i < POOL_SIZE; i++) {
-		listPool.lists[i] = (List){ 0 };
-		listPool.allocated[i] = false;
-		listPool.nextFree[i] = i + 1;
-	}
+	list_pool_init(&listPool);
+}
 
-	listPool.nextFree[POOL_SIZE - 1] = POOL_END;
+ListHandle newListHandle(void) {
+	memStatsCountAlloc(MEM_TAG_LIST_POOL);
+
+	ListHandle handle = list_pool_alloc(&listPool);
+	assert(handle != POOL_NULL_HANDLE);
+
+	return handle;
 }
 
 List *newList(void) {
-	bool outOfSpace = freeListPoolHead == POOL_END;
-	assert(!outOfSpace);
-	if (outOfSpace) {
-		return NULL;
-	}
-
-	listPool.lists[freeListPoolHead] = (List){ 0 };
-	listPool.allocated[freeListPoolHead] = true;
-	List *ret = &listPool.lists[freeListPoolHead];
-	freeListPoolHead = listPool.nextFree[freeListPoolHead];
+	return list_pool_get(&listPool, newListHandle());
+}
 
-	return ret;
+List *getList(ListHandle handle) {
+	return list_pool_get(&listPool, handle);
 }
 
-void freeList(List *list) {
-	uintptr_t list_addr = (uintptr_t)list;
-	uintptr_t pool_addr = (uintptr_t)&listPool;
-	uintptr_t addr_diff = list_addr - pool_addr;
-
-	/* Check for out of range or unaligned */
-	bool validAddress = list_addr >= pool_addr
-		&& list_addr < pool_addr + sizeof(listPool.lists)
-		&& addr_diff % sizeof(List) == 0;
-	assert(validAddress);
-	if (!validAddress) {
-		return;
-	}
+ListHandle getListHandle(const List *list) {
+	return list_pool_handle_of(&listPool, list);
+}
 
-	size_t idx = addr_diff / sizeof(List);
+void freeListHandle(ListHandle handle) {
+	List *list = list_pool_get(&listPool, handle);
 
-	if (!listPool.allocated[idx]) {
+	/* Use after free or double free */
+	assert(list != NULL);
+	if (list == NULL) {
 		return;
 	}
 
-	listPool.nextFree[idx] = freeListPoolHead;
-	listPool.allocated[idx] = false;
-	freeListPoolHead = idx;
+	list_free(list);
+	list_pool_release(&listPool, handle);
+}
+
+void freeList(List *list) {
+	freeListHandle(getListHandle(list));
 }
 
 void cleanupListPool(void)
 {
-	for (size_t i = 0; i < POOL_SIZE; i++) {
-		if (listPool.allocated[i]) {
-			list_free(&listPool.lists[i]);
-		}
+	uint32_t cursor = 0;
+	List *list = NULL;
+
+	while ((list = list_pool_next(&listPool, &cursor)) != NULL) {
+		list_free(list);
 	}
+
+	list_pool_free(&listPool);
 	initListPool();
 }
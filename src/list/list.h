@@ -1,16 +1,31 @@
 #pragma once
 
 #include "vector_base.h"
+#include "../pool/pool_base.h"
 
 VECTOR_DECLARE(List, list, void*)
 VECTOR_DECLARE(ListString, list_string, char*)
+VECTOR_DECLARE(ListFloat, list_float, float)
+
+/* Stale list handles are detected, see pool_base.h */
+typedef PoolHandle ListHandle;
 
 /* Initialize the arena before creating new lists with `newList()` */
 void initListPool(void);
 /* Return a pointer to a list that will be cleaned up by `cleanupListPool()`.
- * The new list is uninitialized, so it's safe to cast to any other list type */
+ * The new list is uninitialized, so it's safe to cast to any other list type.
+ * The pool grows on demand, the returned address stays valid until the list is
+ * freed */
 List *newList(void);
+/* Same as `newList()`, but return a handle that can be validated later */
+ListHandle newListHandle(void);
+/* Return the list behind the handle, or NULL if it was freed */
+List *getList(ListHandle handle);
+/* Return the handle of a list from `newList()`, or POOL_NULL_HANDLE if the list
+ * was freed or does not come from the pool */
+ListHandle getListHandle(const List *list);
 /* Free the list's internal memory and let the arena reclaim the list's slot */
 void freeList(List *list);
+void freeListHandle(ListHandle handle);
 /* Free every list from `newList()` and calls `initListPool()` */
 void cleanupListPool(void);
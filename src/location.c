@@ -0,0 +1,149 @@
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+
+#include "location.h"
+
+_Static_assert(1ull << sizeof(RoomIdx) * CHAR_BIT >= MAX_ROOMS,
+	       "RoomIdx's type cannot address all values of MAX_ROOMS");
+_Static_assert(1ull << sizeof(u32) * CHAR_BIT >= MAX_ENTITIES,
+	       "LocationIndex.rooms.count's type cannot count MAX_ENTITIES");
+
+static void unlinkEntity(
+	struct LocationIndex *index,
+	EntityIdx entity,
+	RoomIdx room
+)
+{
+	EntityIdx next = index->entities.next[entity];
+	EntityIdx prev = index->entities.prev[entity];
+
+	if (prev != 0) {
+		index->entities.next[prev] = next;
+	} else {
+		index->rooms.head[room] = next;
+	}
+
+	if (next != 0) {
+		index->entities.prev[next] = prev;
+	}
+
+	index->entities.next[entity] = 0;
+	index->entities.prev[entity] = 0;
+	index->rooms.count[room] -= 1;
+}
+
+static void linkEntity(
+	struct LocationIndex *index,
+	EntityIdx entity,
+	RoomIdx room
+)
+{
+	EntityIdx head = index->rooms.head[room];
+
+	index->entities.next[entity] = head;
+	index->entities.prev[entity] = 0;
+	if (head != 0) {
+		index->entities.prev[head] = entity;
+	}
+
+	index->rooms.head[room] = entity;
+	index->rooms.count[room] += 1;
+}
+
+void locationIndexInit(struct LocationIndex *index)
+{
+	assert(index != NULL);
+
+	memset(index, 0, sizeof(struct LocationIndex));
+}
+
+void locationIndexBuild(
+	struct LocationIndex *index,
+	const struct EntityComponents *components
+)
+{
+	assert(index != NULL);
+	assert(components != NULL);
+
+	locationIndexInit(index);
+
+	size_t entityCount = (size_t)components->chunkCount * ENTITY_CHUNK_SIZE;
+	if (entityCount == 0) {
+		return;
+	}
+
+	/* Backwards so rooms list their entities in increasing order */
+	for (size_t entity = entityCount - 1; entity > 0; entity--) {
+		RoomIdx room = ENTITY(components, location, entity);
+		assert(room < MAX_ROOMS);
+
+		if (room != 0) {
+			linkEntity(index, (EntityIdx)entity, room);
+		}
+	}
+}
+
+void locationMove(
+	struct LocationIndex *index,
+	struct EntityComponents *components,
+	EntityIdx entity,
+	RoomIdx room
+)
+{
+	assert(index != NULL);
+	assert(components != NULL);
+	assert(entity > 0 && entity / ENTITY_CHUNK_SIZE < components->chunkCount);
+	assert(room < MAX_ROOMS);
+
+	RoomIdx from = ENTITY(components, location, entity);
+	if (from == room) {
+		return;
+	}
+
+	if (from != 0) {
+		unlinkEntity(index, entity, from);
+	}
+	if (room != 0) {
+		linkEntity(index, entity, room);
+	}
+
+	ENTITY(components, location, entity) = room;
+}
+
+u32 locationCount(const struct LocationIndex *index, RoomIdx room)
+{
+	assert(index != NULL);
+	assert(room < MAX_ROOMS);
+
+	return index->rooms.count[room];
+}
+
+struct LocationIterator locationGetEntities(
+	const struct LocationIndex *index,
+	RoomIdx room
+)
+{
+	assert(index != NULL);
+	assert(room > 0 && room < MAX_ROOMS);
+
+	return (struct LocationIterator) {
+		.index = index,
+		.current = index->rooms.head[room],
+	};
+}
+
+bool locationIteratorNext(struct LocationIterator *iter, EntityIdx *out)
+{
+	assert(iter != NULL);
+	assert(out != NULL);
+
+	if (iter->current == 0) {
+		return false;
+	}
+
+	*out = iter->current;
+	iter->current = iter->index->entities.next[iter->current];
+
+	return true;
+}
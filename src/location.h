@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "common.h"
+#include "entity.h"
+#include "room.h"
+
+/* Index of the entities in each room, kept in sync with
+ * `struct EntityComponents.location` by `locationMove()`. Each room holds an
+ * intrusive doubly linked list threaded through the entities, so listing a
+ * room is O(entities in room) and moving an entity is O(1). Entity 0 and room
+ * 0 are null, entities in room 0 are not indexed. */
+struct LocationIndex {
+	struct {
+		EntityIdx head[MAX_ROOMS];
+		u32 count[MAX_ROOMS];
+	} rooms;
+
+	struct {
+		EntityIdx next[MAX_ENTITIES];
+		EntityIdx prev[MAX_ENTITIES];
+	} entities;
+};
+
+struct LocationIterator {
+	const struct LocationIndex *index;
+	EntityIdx current;
+};
+
+void locationIndexInit(struct LocationIndex *index);
+/* Rebuild the index from the location column, e.g. after loading a save */
+void locationIndexBuild(
+	struct LocationIndex *index,
+	const struct EntityComponents *components
+);
+/* Move `entity` to `room`, updating both its location and the index. Moving to
+ * room 0 takes the entity out of the world. */
+void locationMove(
+	struct LocationIndex *index,
+	struct EntityComponents *components,
+	EntityIdx entity,
+	RoomIdx room
+);
+u32 locationCount(const struct LocationIndex *index, RoomIdx room);
+/* Entities are visited most recently moved in first. Moving the entity last
+ * returned by the iterator is allowed, moving any other is not. */
+struct LocationIterator locationGetEntities(
+	const struct LocationIndex *index,
+	RoomIdx room
+);
+bool locationIteratorNext(struct LocationIterator *iter, EntityIdx *out);
@@ -7,36 +7,103 @@
 #include "laz_utils.h"
 
 #include "common.h"
+#include "effects.h"
+#include "intern.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "simulation.h"
 #include "view.h"
+#include "world.h"
 #include "list/list.h"
 
 /* When true, exit at the end of the current frame */
 bool shouldExitGameLoop = false;
 
+static struct World gameWorld;
+static struct Scheduler scheduler;
+
+static Error runEffects(struct World *world)
+{
+	world->newlyDeadCount = effectsTick(
+		&world->entities, world->tickSeconds, world->newlyDead);
+	return ERR_OK;
+}
+
+/* Simulation systems in the order their writes apply, see scheduler.h. They
+ * run on the simulation thread, the view runs on the main thread. */
+static const struct System systems[] = {
+	{
+		.name = "effects",
+		.run = runEffects,
+		.reads = COMPONENT_MAX_HEALTHS | COMPONENT_DAMAGE_OVER_TIME |
+			 COMPONENT_REGENERATION,
+		.writes = COMPONENT_HEALTHS | COMPONENT_NEWLY_DEAD,
+	},
+};
+
 Error init(void)
 {
 	/* Memory allocators */
 	initListPool();
 	initArena();
+	initIntern();
 
 	/* Components */
+	worldInit(&gameWorld);
 	initView();
 
-	return ERR_OK;
+	/* Systems */
+	Error err = schedulerInit(&scheduler, schedulerDefaultWorkerCount());
+	if (err != ERR_OK) {
+		return err;
+	}
+	for (size_t i = 0; i < ARRAY_LENGTH(systems); i++) {
+		schedulerAddSystem(&scheduler, systems[i]);
+	}
+
+	return startSimulation(&gameWorld, &scheduler);
 }
 
-Error gameLoop(void)
+/* Simulation ticks run on their own thread, the profiler gets their timings
+ * from the snapshots */
+static void profileSimulation(void)
 {
-	Step steps[] = {
-		updateView
-	};
+	static u64 lastTick = 0;
+	const struct WorldSnapshot *snapshot = simulationSnapshot();
 
+	if (snapshot->tick != lastTick) {
+		profilerRecord(PROFILE_ZONE_SIMULATION, snapshot->tickStart,
+			       snapshot->tickDuration);
+		lastTick = snapshot->tick;
+	}
+}
+
+Error gameLoop(void)
+{
 	while (shouldExitGameLoop == 0) {
-		for (size_t i = 0; i < ARRAY_LENGTH(steps); i++) {
-			Error err = steps[i]();
-			if (err != ERR_OK) {
-				return err;
-			}
+		u64 frameStart = profilerBegin();
+		profilerNextFrame();
+		frameArenaBegin();
+
+		u64 start = profilerBegin();
+		Error err = updateView();
+		/* Time spent blocked in the view is not the frame's work */
+		u64 idle = viewIdleNanoseconds();
+		profilerRecord(PROFILE_ZONE_VIEW, start,
+			       get_nanoseconds() - start - idle);
+
+		frameArenaEnd();
+		profileSimulation();
+		profilerRecord(PROFILE_ZONE_FRAME, frameStart,
+			       get_nanoseconds() - frameStart - idle);
+
+		if (err != ERR_OK) {
+			return err;
+		}
+
+		err = simulationStatus();
+		if (err != ERR_OK) {
+			return err;
 		}
 	}
 
@@ -45,10 +112,15 @@ Error gameLoop(void)
 
 Error cleanup(void)
 {
+	/* Systems */
+	stopSimulation();
+	schedulerCleanup(&scheduler);
+
 	/* Components */
 	cleanupView();
 
 	/* Memory allocators */
+	cleanupIntern();
 	cleanupArena();
 	cleanupListPool();
 
@@ -67,14 +139,28 @@ int main(void)
 		gameLoop,
 		cleanup
 	};
+	ProfileZone zones[] = {
+		PROFILE_ZONE_INIT,
+		PROFILE_ZONE_GAME_LOOP,
+		PROFILE_ZONE_CLEANUP
+	};
+
+	/* Also calibrates the profiler's clock. Without GAME_TRACE, tracing is
+	 * compiled out and enabling it does nothing. */
+	laz_trace_init();
+	laz_trace_set_enabled(true);
+	initProfiler();
 
 	for (size_t i = 0; i < ARRAY_LENGTH(steps); i++) {
+		u64 start = profilerBegin();
 		Error err = steps[i]();
+		profilerEnd(zones[i], start);
 		if (err != ERR_OK) {
 			errorf("%s\n", errorToString(err));
 			exit(EXIT_FAILURE);
 		}
 	}
 
+	laz_trace_cleanup();
 	exit(EXIT_SUCCESS);
 }
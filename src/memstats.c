@@ -0,0 +1,151 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "memstats.h"
+
+/* Keeps the block after the header aligned like malloc(3) does */
+#define HEADER_SIZE alignof(max_align_t)
+
+_Static_assert(HEADER_SIZE >= sizeof(size_t),
+	       "Tracked block header cannot hold the block's size");
+
+/* Thread arenas report from worker threads. Counters are relaxed atomics: a
+ * snapshot is not consistent across fields, which is fine for telemetry. */
+struct AtomicMemStats {
+	atomic_size_t bytesLive;
+	atomic_size_t bytesPeak;
+	atomic_uint_least64_t allocCount;
+	atomic_size_t chunkCount;
+};
+
+static struct AtomicMemStats stats[MEM_TAG_MAX];
+
+void memStatsAddChunk(MemTag tag, size_t bytes)
+{
+	assert(tag < MEM_TAG_MAX);
+
+	struct AtomicMemStats *s = &stats[tag];
+	size_t live = atomic_fetch_add_explicit(&s->bytesLive, bytes,
+						memory_order_relaxed) + bytes;
+	atomic_fetch_add_explicit(&s->chunkCount, 1, memory_order_relaxed);
+
+	size_t peak = atomic_load_explicit(&s->bytesPeak, memory_order_relaxed);
+	while (peak < live
+	       && !atomic_compare_exchange_weak_explicit(
+		       &s->bytesPeak, &peak, live,
+		       memory_order_relaxed, memory_order_relaxed));
+}
+
+void memStatsRemoveChunk(MemTag tag, size_t bytes)
+{
+	assert(tag < MEM_TAG_MAX);
+
+	struct AtomicMemStats *s = &stats[tag];
+	size_t live = atomic_fetch_sub_explicit(&s->bytesLive, bytes,
+						memory_order_relaxed);
+	size_t chunks = atomic_fetch_sub_explicit(&s->chunkCount, 1,
+						  memory_order_relaxed);
+	assert(live >= bytes && chunks > 0);
+	(void)live;
+	(void)chunks;
+}
+
+void memStatsCountAlloc(MemTag tag)
+{
+	assert(tag < MEM_TAG_MAX);
+
+	atomic_fetch_add_explicit(&stats[tag].allocCount, 1,
+				  memory_order_relaxed);
+}
+
+struct MemStats memStatsGet(MemTag tag)
+{
+	assert(tag < MEM_TAG_MAX);
+
+	struct AtomicMemStats *s = &stats[tag];
+
+	return (struct MemStats) {
+		.bytesLive = atomic_load_explicit(&s->bytesLive,
+						  memory_order_relaxed),
+		.bytesPeak = atomic_load_explicit(&s->bytesPeak,
+						  memory_order_relaxed),
+		.allocCount = atomic_load_explicit(&s->allocCount,
+						   memory_order_relaxed),
+		.chunkCount = atomic_load_explicit(&s->chunkCount,
+						   memory_order_relaxed),
+	};
+}
+
+struct MemStats memStatsTotal(void)
+{
+	struct MemStats total = { 0 };
+
+	for (MemTag tag = 0; tag < MEM_TAG_MAX; tag++) {
+		struct MemStats s = memStatsGet(tag);
+		total.bytesLive += s.bytesLive;
+		total.bytesPeak += s.bytesPeak;
+		total.allocCount += s.allocCount;
+		total.chunkCount += s.chunkCount;
+	}
+
+	return total;
+}
+
+const char *memTagToString(MemTag tag)
+{
+	switch (tag) {
+	case MEM_TAG_ARENA: return "arena";
+	case MEM_TAG_FRAME_ARENA: return "frame arena";
+	case MEM_TAG_THREAD_ARENA: return "thread arenas";
+	case MEM_TAG_LARGE_ARENA: return "large arena";
+	case MEM_TAG_SHARED_ARENA: return "shared arena";
+	case MEM_TAG_LIST_POOL: return "list pool";
+	case MEM_TAG_VECTOR: return "vectors";
+	case MEM_TAG_HASHMAP: return "hash maps";
+	case MEM_TAG_CLAY: return "clay";
+	default: return "unknown";
+	}
+}
+
+void *memTrackedReallocChunk(MemTag tag, void *ptr, size_t size)
+{
+	assert(size <= (size_t)-1 - HEADER_SIZE);
+
+	char *block = NULL;
+	size_t oldSize = 0;
+
+	if (ptr != NULL) {
+		block = (char *)ptr - HEADER_SIZE;
+		oldSize = *(size_t *)(void *)block;
+		memStatsRemoveChunk(tag, oldSize);
+	}
+
+	block = realloc_try(block, size + HEADER_SIZE);
+	*(size_t *)(void *)block = size;
+
+	memStatsAddChunk(tag, size);
+
+	return block + HEADER_SIZE;
+}
+
+void *memTrackedRealloc(MemTag tag, void *ptr, size_t size)
+{
+	void *result = memTrackedReallocChunk(tag, ptr, size);
+	memStatsCountAlloc(tag);
+
+	return result;
+}
+
+void memTrackedFree(MemTag tag, void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	char *block = (char *)ptr - HEADER_SIZE;
+	memStatsRemoveChunk(tag, *(size_t *)(void *)block);
+	free(block);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "laz_utils.h"
+
+/* Memory accounting per subsystem. Allocators report the blocks they get from
+ * the system allocator (obstack chunks, pool chunks, vector buffers...) and
+ * how many allocations they serve from them. Safe to call from any thread. */
+
+typedef enum MemTag {
+	MEM_TAG_ARENA = 0,
+	MEM_TAG_FRAME_ARENA,
+	MEM_TAG_THREAD_ARENA,
+	MEM_TAG_LARGE_ARENA,
+	MEM_TAG_SHARED_ARENA,
+	MEM_TAG_LIST_POOL,
+	MEM_TAG_VECTOR,
+	MEM_TAG_HASHMAP,
+	MEM_TAG_CLAY,
+	MEM_TAG_MAX,
+} MemTag;
+
+struct MemStats {
+	/* Bytes currently held from the system allocator */
+	size_t bytesLive;
+	/* Highest bytesLive since startup */
+	size_t bytesPeak;
+	/* Allocations served, including those that did not need a new chunk */
+	u64 allocCount;
+	/* Blocks currently held from the system allocator */
+	size_t chunkCount;
+};
+
+/* A block of `bytes` was obtained from, or returned to, the system */
+void memStatsAddChunk(MemTag tag, size_t bytes);
+void memStatsRemoveChunk(MemTag tag, size_t bytes);
+void memStatsCountAlloc(MemTag tag);
+struct MemStats memStatsGet(MemTag tag);
+/* Sum of every tag, the peak is the sum of peaks */
+struct MemStats memStatsTotal(void);
+const char *memTagToString(MemTag tag);
+
+/* realloc(3)/free(3) that account for the block under `tag`. The block's size
+ * is kept in a header, so blocks must not be mixed with realloc(3)/free(3).
+ * These functions will perror and EXIT_FAILURE if no memory is returned. */
+void *memTrackedRealloc(MemTag tag, void *ptr, size_t size);
+/* memTrackedRealloc() that leaves allocCount alone, for allocators that count
+ * the allocations they serve from the block themselves */
+void *memTrackedReallocChunk(MemTag tag, void *ptr, size_t size);
+void memTrackedFree(MemTag tag, void *ptr);
@@ -0,0 +1,251 @@
+#include "message_log.h"
+
+#include <assert.h>
+#include <string.h>
+
+/* An entry of the index file */
+struct MessageRecord {
+	u64 offset;
+	u32 length;
+	u32 reserved;
+};
+
+_Static_assert(MESSAGE_LOG_RING_BYTES > MESSAGE_LOG_MAX_LENGTH,
+	       "The ring cannot hold the longest message");
+
+Error messageLogInit(struct MessageLog *log, const char *path)
+{
+	assert(path != NULL);
+
+	memset(log, 0, sizeof(*log));
+
+	log->history = fopen(path, "w+b");
+	log->index = tmpfile();
+	if (log->history != NULL && log->index != NULL) {
+		return ERR_OK;
+	}
+
+	/* The history is useless without its index, keep only the ring */
+	if (log->history != NULL) {
+		fclose(log->history);
+		log->history = NULL;
+	}
+	if (log->index != NULL) {
+		fclose(log->index);
+		log->index = NULL;
+	}
+	log->historyFailed = true;
+
+	return ERR_FILE_WRITING_FAILED;
+}
+
+void messageLogCleanup(struct MessageLog *log)
+{
+	if (log->history != NULL) {
+		fclose(log->history);
+	}
+	if (log->index != NULL) {
+		fclose(log->index);
+	}
+	memset(log, 0, sizeof(*log));
+}
+
+static struct MessageEntry *getEntry(struct MessageLog *log, u64 index)
+{
+	return &log->entries[index % MESSAGE_LOG_RING_ENTRIES];
+}
+
+/* Make room in the ring for `size` bytes, dropping the oldest messages, and
+ * return where they go */
+static u32 reserveRing(struct MessageLog *log, u32 size)
+{
+	u32 start = log->ringHead;
+
+	/* The end of the ring is too short: the messages there are older than
+	 * those at its start, drop them and wrap */
+	if (start + size > MESSAGE_LOG_RING_BYTES) {
+		while (log->first < log->count
+		       && getEntry(log, log->first)->offset >= start) {
+			log->first++;
+		}
+		start = 0;
+	}
+
+	/* The oldest messages are now the ones right after `start` */
+	while (log->first < log->count) {
+		const struct MessageEntry *oldest = getEntry(log, log->first);
+		bool full = log->count - log->first >= MESSAGE_LOG_RING_ENTRIES;
+		bool overlaps = oldest->offset < start + size
+			&& oldest->offset + oldest->length + 1 > start;
+
+		if (!full && !overlaps) {
+			break;
+		}
+		log->first++;
+	}
+
+	return start;
+}
+
+static Error appendHistory(struct MessageLog *log, const char *text, u32 length)
+{
+	struct MessageRecord record = {
+		.offset = log->historySize,
+		.length = length,
+	};
+
+	/* Both files are also read from, position them back at their end */
+	if (fseek(log->history, 0, SEEK_END) != 0
+	    || fseek(log->index, 0, SEEK_END) != 0) {
+		return ERR_FILE_WRITING_FAILED;
+	}
+	if (fwrite(text, 1, length, log->history) != length
+	    || fputc('\n', log->history) == EOF
+	    || fwrite(&record, sizeof(record), 1, log->index) != 1) {
+		return ERR_FILE_WRITING_FAILED;
+	}
+	if (fflush(log->history) != 0 || fflush(log->index) != 0) {
+		return ERR_FILE_WRITING_FAILED;
+	}
+
+	log->historySize += length + 1;
+	log->historyCount++;
+
+	return ERR_OK;
+}
+
+Error messageLogPush(struct MessageLog *log, const char *text)
+{
+	assert(text != NULL);
+
+	size_t length = strlen(text);
+	if (length > MESSAGE_LOG_MAX_LENGTH) {
+		length = MESSAGE_LOG_MAX_LENGTH;
+		/* Back off to the start of the sequence the limit cuts, the byte
+		 * at the limit continues it */
+		while (length > 0
+		       && ((unsigned char)text[length] & 0xC0) == 0x80) {
+			length--;
+		}
+	}
+
+	Error err = ERR_OK;
+	if (!log->historyFailed) {
+		err = appendHistory(log, text, (u32)length);
+		log->historyFailed = err != ERR_OK;
+	}
+
+	u32 start = reserveRing(log, (u32)length + 1);
+	memcpy(&log->ring[start], text, length);
+	log->ring[start + length] = '\0';
+	*getEntry(log, log->count) = (struct MessageEntry) {
+		.offset = start,
+		.length = (u32)length,
+	};
+	log->ringHead = start + (u32)length + 1;
+	log->count++;
+
+	return err;
+}
+
+u64 messageLogCount(const struct MessageLog *log)
+{
+	return log->count;
+}
+
+static Error readPage(struct MessageLog *log, struct MessagePage *page)
+{
+	struct MessageRecord records[MESSAGE_LOG_PAGE_ENTRIES];
+	u64 first = page->number * MESSAGE_LOG_PAGE_ENTRIES;
+	u64 count = log->historyCount - first;
+
+	if (count > MESSAGE_LOG_PAGE_ENTRIES) {
+		count = MESSAGE_LOG_PAGE_ENTRIES;
+	}
+
+	if (fseek(log->index, (long)(first * sizeof(records[0])), SEEK_SET) != 0
+	    || fread(records, sizeof(records[0]), count, log->index) != count) {
+		return ERR_FILE_READING_FAILED;
+	}
+
+	/* The page's messages are contiguous in the history, with their
+	 * newlines, which become the terminators */
+	u64 start = records[0].offset;
+	u64 end = records[count - 1].offset + records[count - 1].length + 1;
+	assert(end - start <= sizeof(page->text));
+
+	if (fseek(log->history, (long)start, SEEK_SET) != 0
+	    || fread(page->text, 1, end - start, log->history) != end - start) {
+		return ERR_FILE_READING_FAILED;
+	}
+
+	for (u64 i = 0; i < count; i++) {
+		page->offsets[i] = (u32)(records[i].offset - start);
+		page->text[page->offsets[i] + records[i].length] = '\0';
+	}
+	page->count = (u32)count;
+
+	return ERR_OK;
+}
+
+/* The page holding message `index`, read into the least recently used slot
+ * if it isn't loaded. A page read while it wasn't full is read again. */
+static struct MessagePage *getPage(struct MessageLog *log, u64 index)
+{
+	u64 number = index / MESSAGE_LOG_PAGE_ENTRIES;
+	u32 slot = (u32)(index % MESSAGE_LOG_PAGE_ENTRIES);
+	struct MessagePage *victim = &log->pages[0];
+
+	for (size_t i = 0; i < MESSAGE_LOG_PAGE_SLOTS; i++) {
+		struct MessagePage *page = &log->pages[i];
+		if (page->loaded && page->number == number) {
+			if (slot >= page->count) {
+				victim = page;
+				break;
+			}
+			page->lastUse = ++log->pageClock;
+			return page;
+		}
+		if (!page->loaded
+		    || (victim->loaded && page->lastUse < victim->lastUse)) {
+			victim = page;
+		}
+	}
+
+	victim->number = number;
+	victim->loaded = readPage(log, victim) == ERR_OK;
+	if (!victim->loaded) {
+		return NULL;
+	}
+	victim->lastUse = ++log->pageClock;
+
+	return victim;
+}
+
+const char *messageLogGet(struct MessageLog *log, u64 index)
+{
+	if (index >= log->count) {
+		return NULL;
+	}
+
+	if (index >= log->first) {
+		return &log->ring[getEntry(log, index)->offset];
+	}
+
+	/* Lost, the history failed before it was written */
+	if (index >= log->historyCount) {
+		return NULL;
+	}
+
+	struct MessagePage *page = getPage(log, index);
+	if (page == NULL) {
+		return NULL;
+	}
+
+	return &page->text[page->offsets[index % MESSAGE_LOG_PAGE_ENTRIES]];
+}
+
+bool messageLogIsPaged(const struct MessageLog *log, u64 index)
+{
+	return index < log->first;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "common.h"
+#include "errors.h"
+
+/* History of the messages shown to the player, in constant memory. The
+ * latest messages stay in a ring, the text of each one contiguous in a
+ * single buffer. Every message is also appended to a history file, and the
+ * older ones are read back from it a page at a time when asked for. */
+
+#define MESSAGE_LOG_FILE "messages.log"
+/* In bytes, longer messages are cut, see `messageLogPush()` */
+#define MESSAGE_LOG_MAX_LENGTH 4095
+#define MESSAGE_LOG_RING_ENTRIES 512
+#define MESSAGE_LOG_RING_BYTES (64 * 1024)
+#define MESSAGE_LOG_PAGE_ENTRIES 64
+#define MESSAGE_LOG_PAGE_SLOTS 4
+
+struct MessageEntry {
+	/* Into the ring's text, NUL terminated */
+	u32 offset;
+	u32 length;
+};
+
+/* Messages [number * MESSAGE_LOG_PAGE_ENTRIES, + count) read from the
+ * history file */
+struct MessagePage {
+	u64 number;
+	/* For evicting the least recently used page */
+	u64 lastUse;
+	u32 count;
+	bool loaded;
+	u32 offsets[MESSAGE_LOG_PAGE_ENTRIES];
+	char text[MESSAGE_LOG_PAGE_ENTRIES * (MESSAGE_LOG_MAX_LENGTH + 1)];
+};
+
+struct MessageLog {
+	/* One message per line, followed by its newline */
+	FILE *history;
+	/* Where each message starts in the history, deleted when closed */
+	FILE *index;
+	u64 historySize;
+	/* Messages written to the history. Writing stops at the first error,
+	 * the later messages are lost once they leave the ring. */
+	u64 historyCount;
+	bool historyFailed;
+	/* Messages pushed so far, the ring holds [first, count) */
+	u64 count;
+	u64 first;
+	struct MessageEntry entries[MESSAGE_LOG_RING_ENTRIES];
+	/* Where the next message's text goes */
+	u32 ringHead;
+	char ring[MESSAGE_LOG_RING_BYTES];
+	struct MessagePage pages[MESSAGE_LOG_PAGE_SLOTS];
+	u64 pageClock;
+};
+
+/* The history file at `path` is truncated. If it or its index cannot be
+ * created, an error is returned but the log still works without a history,
+ * as if writing it failed before the first message. */
+Error messageLogInit(struct MessageLog *log, const char *path);
+void messageLogCleanup(struct MessageLog *log);
+/* Copy `text` into the log. The message is kept even if it could not be
+ * written to the history, only the older ones would be lost. Messages longer
+ * than MESSAGE_LOG_MAX_LENGTH bytes are cut before the UTF-8 sequence that
+ * crosses the limit, so the text kept is still valid UTF-8. */
+Error messageLogPush(struct MessageLog *log, const char *text);
+u64 messageLogCount(const struct MessageLog *log);
+/* Text of message `index`, NUL terminated, or NULL if it is lost. Valid until
+ * the next push, or until MESSAGE_LOG_PAGE_SLOTS other pages were read. */
+const char *messageLogGet(struct MessageLog *log, u64 index);
+/* Whether message `index` left the ring, its text then comes from a page */
+bool messageLogIsPaged(const struct MessageLog *log, u64 index);
@@ -1,19 +1,318 @@
+/* MAP_ANONYMOUS and madvise(2) */
+#define _DEFAULT_SOURCE
+
 #include "arena.h"
+#include "../laz_utils.h"
 
 #include <assert.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../memstats.h"
+#include "../thread.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define ARENA_HAVE_MMAP
+#endif
+
+/* Initial size of a frame buffer's chunk. A frame that spills over it doubles
+ * it, so the steady state does not touch malloc. */
+#define FRAME_ARENA_CHUNK_SIZE (64 * 1024)
+#define FRAME_ARENA_BUFFERS 2
+
+/* One huge page on x86-64 and most aarch64 kernels. The large arena's chunks
+ * are one of these, so a whole chunk is covered by a single TLB entry. */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define LARGE_ARENA_CHUNK_SIZE HUGE_PAGE_SIZE
+#define LARGE_ARENA_FLAGS (ARENA_MMAP | ARENA_HUGE_PAGES | ARENA_PREFAULT)
+
+/* Where an obstack's chunks come from and what they are accounted under */
+struct ChunkProvider {
+	MemTag tag;
+	ArenaFlags flags;
+};
+
+struct FrameBuffer {
+	struct obstack stack;
+	/* Empty object at the start of the first chunk, freeing it resets */
+	void *base;
+	struct _obstack_chunk *firstChunk;
+	size_t chunkSize;
+};
+
+/* Thread arena allocations handed off with `handOffThreadArena()` */
+struct AdoptedArena {
+	struct obstack stack;
+	struct AdoptedArena *next;
+};
 
 struct obstack arena;
+/* Created by the first `largeArenaAlloc()`, a run that never needs it does
+ * not map and fault in a huge page */
+static struct obstack largeArena;
+static bool largeArenaCreated;
+
+static const struct ChunkProvider arenaProvider = { MEM_TAG_ARENA, 0 };
+static const struct ChunkProvider frameArenaProvider = { MEM_TAG_FRAME_ARENA, 0 };
+static const struct ChunkProvider threadArenaProvider = { MEM_TAG_THREAD_ARENA, 0 };
+static const struct ChunkProvider largeArenaProvider = { MEM_TAG_LARGE_ARENA,
+							 LARGE_ARENA_FLAGS };
+static const struct ChunkProvider sharedArenaProvider = { MEM_TAG_SHARED_ARENA, 0 };
+
+/* Long-lived allocations from any thread, see `sharedArenaAlloc()` */
+static struct obstack sharedArena;
+static mtx_t sharedArenaLock;
+
+/* Thread owning the world's memory, see `claimWorldMemory()`. Threads are
+ * numbered from 1 the first time they ask. */
+static atomic_uint worldMemoryOwner;
+static atomic_uint threadsNumbered;
+static _Thread_local unsigned threadNumber;
+
+/* Set on threads that called `initThreadArena()`, NULL on the main thread */
+static _Thread_local struct obstack *threadArena;
+static _Thread_local struct obstack threadArenaStack;
+static _Thread_local void *threadArenaBase;
+
+static mtx_t adoptedArenasLock;
+static struct AdoptedArena *adoptedArenas;
+
+static struct FrameBuffer frameBuffers[FRAME_ARENA_BUFFERS];
+static size_t currentFrameBuffer;
+static bool frameOpen;
 
 /* Note: obstacks abort on allocation errors, no error management needed */
 
+static size_t systemPageSize(void)
+{
+#ifdef ARENA_HAVE_MMAP
+	static size_t size = 0;
+	if (size == 0) {
+		long result = sysconf(_SC_PAGESIZE);
+		size = result > 0 ? (size_t)result : 4096;
+	}
+	return size;
+#else
+	return 4096;
+#endif
+}
+
+/* Size actually mapped for a chunk of `size` bytes. Only depends on the
+ * requested size so `freeChunk()` can recompute it from the chunk's limit. */
+static size_t chunkMappedSize(size_t size, ArenaFlags flags)
+{
+	if (!(flags & (ARENA_MMAP | ARENA_HUGE_PAGES))) {
+		return size;
+	}
+
+	size_t granularity = flags & ARENA_HUGE_PAGES ? HUGE_PAGE_SIZE :
+							systemPageSize();
+	return (size + granularity - 1) & ~(granularity - 1);
+}
+
+/* Write to every page now rather than on first touch during play */
+static void prefaultChunk(char *chunk, size_t size)
+{
+	size_t step = systemPageSize();
+
+	for (size_t i = 0; i < size; i += step) {
+		((volatile char *)chunk)[i] = 0;
+	}
+}
+
+#ifdef ARENA_HAVE_MMAP
+static void *mapChunk(size_t size, ArenaFlags flags)
+{
+	/* Transparent huge pages only back aligned ranges, map one huge page
+	 * more than needed and trim the unaligned ends */
+	size_t alignment = flags & ARENA_HUGE_PAGES ? HUGE_PAGE_SIZE : 0;
+	char *map = mmap(NULL, size + alignment, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (map == MAP_FAILED) {
+		return NULL;
+	}
+
+	if (alignment == 0) {
+		return map;
+	}
+
+	char *chunk = (char *)(((uintptr_t)map + alignment - 1) &
+			       ~(uintptr_t)(alignment - 1));
+	size_t head = (size_t)(chunk - map);
+
+	if (head > 0) {
+		munmap(map, head);
+	}
+	if (alignment - head > 0) {
+		munmap(chunk + size, alignment - head);
+	}
+
+#ifdef MADV_HUGEPAGE
+	/* Advisory, the kernel may have THP disabled */
+	(void)madvise(chunk, size, MADV_HUGEPAGE);
+#endif
+
+	return chunk;
+}
+#endif
+
+/* Chunk allocators for obstacks, `provider` is their `struct ChunkProvider` */
+static void *allocChunk(void *provider, size_t size)
+{
+	const struct ChunkProvider *p = provider;
+	size_t mappedSize = chunkMappedSize(size, p->flags);
+	void *chunk;
+
+#ifdef ARENA_HAVE_MMAP
+	if (p->flags & (ARENA_MMAP | ARENA_HUGE_PAGES)) {
+		chunk = mapChunk(mappedSize, p->flags);
+	} else {
+		chunk = malloc(mappedSize);
+	}
+#else
+	chunk = malloc(mappedSize);
+#endif
+
+	if (chunk == NULL) {
+		return NULL;
+	}
+
+	if (p->flags & ARENA_PREFAULT) {
+		prefaultChunk(chunk, mappedSize);
+	}
+	memStatsAddChunk(p->tag, mappedSize);
+
+	return chunk;
+}
+
+static void freeChunk(void *provider, void *chunk)
+{
+	const struct ChunkProvider *p = provider;
+	struct _obstack_chunk *c = chunk;
+	size_t mappedSize = chunkMappedSize((size_t)(c->limit - (char *)c),
+					    p->flags);
+
+	memStatsRemoveChunk(p->tag, mappedSize);
+
+#ifdef ARENA_HAVE_MMAP
+	if (p->flags & (ARENA_MMAP | ARENA_HUGE_PAGES)) {
+		munmap(chunk, mappedSize);
+		return;
+	}
+#endif
+	free(chunk);
+}
+
+static void initTrackedObstack(struct obstack *h, size_t chunkSize,
+			       const struct ChunkProvider *provider)
+{
+	obstack_specify_allocation_with_arg(h, chunkSize, 0, allocChunk,
+					    freeChunk, (void *)provider);
+}
+
+static void *allocAligned(struct obstack *h, size_t size, size_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	/* Room for the worst case padding first, so the object cannot move to
+	 * a new chunk once the padding is known */
+	obstack_make_room(h, size + alignment - 1);
+
+	size_t padding = -(uintptr_t)obstack_next_free(h) & (alignment - 1);
+	obstack_blank_fast(h, padding + size);
+
+	return (char *)obstack_finish(h) + padding;
+}
+
+static unsigned currentThreadNumber(void)
+{
+	if (threadNumber == 0) {
+		threadNumber = atomic_fetch_add(&threadsNumbered, 1) + 1;
+	}
+	return threadNumber;
+}
+
+/* The arena `arenaAlloc()` allocates from on the calling thread */
+static struct obstack *currentArena(void)
+{
+	return threadArena != NULL ? threadArena : &arena;
+}
+
+static void initFrameBuffer(struct FrameBuffer *buffer, size_t chunkSize)
+{
+	initTrackedObstack(&buffer->stack, chunkSize, &frameArenaProvider);
+	buffer->base = obstack_alloc(&buffer->stack, 0);
+	buffer->firstChunk = buffer->stack.chunk;
+	buffer->chunkSize = chunkSize;
+}
+
+static void resetFrameBuffer(struct FrameBuffer *buffer)
+{
+	/* The last frame spilled into more chunks, grow instead of paying for
+	 * the extra chunks every frame */
+	if (buffer->stack.chunk != buffer->firstChunk) {
+		size_t chunkSize = buffer->chunkSize * 2;
+		obstack_free(&buffer->stack, NULL);
+		initFrameBuffer(buffer, chunkSize);
+		return;
+	}
+
+	obstack_free(&buffer->stack, buffer->base);
+	buffer->base = obstack_alloc(&buffer->stack, 0);
+}
+
 Error initArena(void)
 {
-	obstack_init(&arena);
+	initTrackedObstack(&arena, 0, &arenaProvider);
+	largeArenaCreated = false;
+	claimWorldMemory();
+
+	for (size_t i = 0; i < FRAME_ARENA_BUFFERS; i++) {
+		initFrameBuffer(&frameBuffers[i], FRAME_ARENA_CHUNK_SIZE);
+	}
+	currentFrameBuffer = 0;
+	frameOpen = false;
+
+	adoptedArenas = NULL;
+	if (mtx_init(&adoptedArenasLock, mtx_plain) != thrd_success) {
+		return ERR_OUT_OF_MEMORY;
+	}
+
+	initTrackedObstack(&sharedArena, 0, &sharedArenaProvider);
+	if (mtx_init(&sharedArenaLock, mtx_plain) != thrd_success) {
+		return ERR_OUT_OF_MEMORY;
+	}
+
 	return ERR_OK;
 }
 
 Error cleanupArena(void)
 {
+	while (adoptedArenas != NULL) {
+		struct AdoptedArena *next = adoptedArenas->next;
+		obstack_free(&adoptedArenas->stack, NULL);
+		free(adoptedArenas);
+		adoptedArenas = next;
+	}
+	mtx_destroy(&adoptedArenasLock);
+
+	obstack_free(&sharedArena, NULL);
+	mtx_destroy(&sharedArenaLock);
+
+	for (size_t i = 0; i < FRAME_ARENA_BUFFERS; i++) {
+		obstack_free(&frameBuffers[i].stack, NULL);
+	}
+
+	if (largeArenaCreated) {
+		obstack_free(&largeArena, NULL);
+		largeArenaCreated = false;
+	}
 	obstack_free(&arena, NULL);
 	return ERR_OK;
 }
@@ -22,10 +321,176 @@ char *duplicateString(const char *str)
 {
 	assert(str != NULL);
 
-	return obstack_copy0(&arena, str, strlen(str));
+	struct obstack *h = currentArena();
+
+	memStatsCountAlloc(h == &arena ? MEM_TAG_ARENA : MEM_TAG_THREAD_ARENA);
+	return obstack_copy0(h, str, strlen(str));
 }
 
 void *arenaAlloc(size_t size)
 {
-	return obstack_alloc(&arena, size);
+	struct obstack *h = currentArena();
+
+	memStatsCountAlloc(h == &arena ? MEM_TAG_ARENA : MEM_TAG_THREAD_ARENA);
+	return obstack_alloc(h, size);
+}
+
+void *arenaAllocAligned(size_t size, size_t alignment)
+{
+	struct obstack *h = currentArena();
+
+	memStatsCountAlloc(h == &arena ? MEM_TAG_ARENA : MEM_TAG_THREAD_ARENA);
+	return allocAligned(h, size, alignment);
+}
+
+void *largeArenaAlloc(size_t size, size_t alignment)
+{
+	assert(ownsWorldMemory());
+
+	if (!largeArenaCreated) {
+		initTrackedObstack(&largeArena, LARGE_ARENA_CHUNK_SIZE,
+				   &largeArenaProvider);
+		largeArenaCreated = true;
+	}
+
+	memStatsCountAlloc(MEM_TAG_LARGE_ARENA);
+	return allocAligned(&largeArena, size, alignment);
+}
+
+void *sharedArenaAlloc(size_t size, size_t alignment)
+{
+	mtx_lock(&sharedArenaLock);
+	memStatsCountAlloc(MEM_TAG_SHARED_ARENA);
+	void *result = allocAligned(&sharedArena, size, alignment);
+	mtx_unlock(&sharedArenaLock);
+
+	return result;
+}
+
+char *sharedDuplicateString(const char *str)
+{
+	assert(str != NULL);
+
+	size_t size = strlen(str) + 1;
+	char *copy = sharedArenaAlloc(size, 1);
+	memcpy(copy, str, size);
+
+	return copy;
+}
+
+void claimWorldMemory(void)
+{
+	atomic_store(&worldMemoryOwner, currentThreadNumber());
+}
+
+bool ownsWorldMemory(void)
+{
+	return atomic_load(&worldMemoryOwner) == currentThreadNumber();
+}
+
+Error initThreadArena(void)
+{
+	assert(threadArena == NULL);
+
+	initTrackedObstack(&threadArenaStack, 0, &threadArenaProvider);
+	threadArenaBase = obstack_alloc(&threadArenaStack, 0);
+	threadArena = &threadArenaStack;
+
+	return ERR_OK;
+}
+
+Error cleanupThreadArena(void)
+{
+	assert(threadArena != NULL);
+
+	obstack_free(threadArena, NULL);
+	threadArena = NULL;
+	threadArenaBase = NULL;
+
+	return ERR_OK;
+}
+
+void resetThreadArena(void)
+{
+	assert(threadArena != NULL);
+
+	obstack_free(threadArena, threadArenaBase);
+	threadArenaBase = obstack_alloc(threadArena, 0);
+}
+
+void handOffThreadArena(void)
+{
+	assert(threadArena != NULL);
+
+	/* The obstack's chunks change owner without being copied, the lock is
+	 * only held to link them */
+	struct AdoptedArena *adopted = malloc_try(sizeof(struct AdoptedArena));
+	adopted->stack = threadArenaStack;
+
+	mtx_lock(&adoptedArenasLock);
+	adopted->next = adoptedArenas;
+	adoptedArenas = adopted;
+	mtx_unlock(&adoptedArenasLock);
+
+	threadArena = NULL;
+	initThreadArena();
+}
+
+void frameArenaBegin(void)
+{
+	assert(!frameOpen);
+
+	/* The other buffer still holds the last frame's memory */
+	currentFrameBuffer = (currentFrameBuffer + 1) % FRAME_ARENA_BUFFERS;
+	resetFrameBuffer(&frameBuffers[currentFrameBuffer]);
+	frameOpen = true;
+}
+
+void frameArenaEnd(void)
+{
+	assert(frameOpen);
+
+	frameOpen = false;
+}
+
+void *frameAlloc(size_t size)
+{
+	assert(frameOpen);
+
+	memStatsCountAlloc(MEM_TAG_FRAME_ARENA);
+	return obstack_alloc(&frameBuffers[currentFrameBuffer].stack, size);
+}
+
+char *frameDuplicateString(const char *str)
+{
+	assert(frameOpen);
+	assert(str != NULL);
+
+	memStatsCountAlloc(MEM_TAG_FRAME_ARENA);
+	return obstack_copy0(&frameBuffers[currentFrameBuffer].stack, str,
+			     strlen(str));
+}
+
+char *frameSprintf(const char *format, ...)
+{
+	assert(frameOpen);
+	assert(format != NULL);
+
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(NULL, 0, format, args);
+	va_end(args);
+
+	assert(length >= 0);
+	if (length < 0) {
+		return frameDuplicateString("");
+	}
+
+	char *str = frameAlloc((size_t)length + 1);
+
+	va_start(args, format);
+	(void)vsnprintf(str, (size_t)length + 1, format, args);
+	va_end(args);
+
+	return str;
 }
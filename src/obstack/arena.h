@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include "../errors.h"
 
@@ -9,7 +10,67 @@
 
 extern struct obstack arena;
 
+/* Chunk providers of the arenas */
+typedef enum ArenaFlags {
+	/* Chunks are mapped with mmap(2) instead of malloc(3) */
+	ARENA_MMAP = 1 << 0,
+	/* Chunks are huge page aligned and advised for transparent huge pages,
+	 * implies ARENA_MMAP */
+	ARENA_HUGE_PAGES = 1 << 1,
+	/* Chunks are written to when allocated so play does not page fault */
+	ARENA_PREFAULT = 1 << 2,
+} ArenaFlags;
+
 Error initArena(void);
 Error cleanupArena(void);
+/* Allocate from the calling thread's arena if it has one, otherwise from the
+ * global arena. The global arena is not thread safe, only the main thread may
+ * use it. */
 char *duplicateString(const char *str);
 void *arenaAlloc(size_t size);
+/* `alignment` must be a power of two, e.g. 32 or 64 for SIMD columns */
+void *arenaAllocAligned(size_t size, size_t alignment);
+
+/* Allocate large, long-lived tables (entity columns, world data) from huge
+ * pages that are faulted in up front. The first call creates the large arena.
+ * mmap(2) is only used where available, malloc(3) otherwise. Only the thread
+ * owning the world's memory may call it, freed by `cleanupArena()`. */
+void *largeArenaAlloc(size_t size, size_t alignment);
+
+/* Long-lived allocations from any thread, serialized by a lock. For data that
+ * must outlive the tick or system creating it, which thread arenas don't,
+ * e.g. entity text chunks and interned strings. Freed by `cleanupArena()`. */
+void *sharedArenaAlloc(size_t size, size_t alignment);
+char *sharedDuplicateString(const char *str);
+
+/* The world's containers (entity chunks, interned strings) grow on a single
+ * thread, the one owning the world's memory: the thread that called
+ * `initArena()` until another claims it. The simulation thread claims it
+ * while it runs the ticks, systems that spawn entities or intern strings must
+ * then run on it, see SYSTEM_MAIN_THREAD. */
+void claimWorldMemory(void);
+bool ownsWorldMemory(void);
+
+/* Per-thread arenas for worker threads, allocating without locks. After
+ * `initThreadArena()`, `arenaAlloc()` and `duplicateString()` use the thread's
+ * own arena. `resetThreadArena()` frees everything allocated since the last
+ * reset or hand-off, typically once per worker frame. `handOffThreadArena()`
+ * keeps the thread's allocations alive until `cleanupArena()`, so objects can
+ * outlive the worker's frame, and starts a fresh arena. `cleanupThreadArena()`
+ * frees what was not handed off, call it before the thread exits. The
+ * simulation thread and the scheduler's workers reset theirs after every tick
+ * and system, world data goes to `sharedArenaAlloc()` instead. */
+Error initThreadArena(void);
+Error cleanupThreadArena(void);
+void resetThreadArena(void);
+void handOffThreadArena(void);
+
+/* Per-frame scratch memory, reset by `frameArenaBegin()` once per game loop
+ * iteration. The frame arena is double buffered: memory from `frameAlloc()`
+ * stays valid until the end of the next frame, so render data can survive one
+ * extra frame. Allocating outside of a frame is undefined behavior. */
+void frameArenaBegin(void);
+void frameArenaEnd(void);
+void *frameAlloc(size_t size);
+char *frameDuplicateString(const char *str);
+char *frameSprintf(const char *format, ...);
@@ -0,0 +1,333 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Library to generate type-safe object pools addressed by generational
+ * handles.
+ *
+ * To generate pools, use the macros POOL_DECLARE() to generate the header, and
+ * POOL_DEFINE() to generate the source, the same way as VECTOR_DECLARE() and
+ * VECTOR_DEFINE() from vector_base.h.
+ *
+ * Objects live in fixed-size chunks of POOL_CHUNK_SIZE slots. Chunks are never
+ * moved or freed before `pool_free()`, so pointers to objects stay valid for as
+ * long as the object is allocated. The pool grows one chunk at a time, up to
+ * POOL_MAX_OBJECTS objects.
+ *
+ * A handle is 32 bits: the low POOL_INDEX_BITS bits are the slot index, the
+ * remaining bits are the slot's generation. Releasing an object bumps its
+ * slot's generation, so every handle to it becomes stale, and accessing a stale
+ * handle returns NULL instead of aliasing whatever reuses the slot. The
+ * generation wraps after 4095 reuses of the same slot. POOL_NULL_HANDLE (0) is
+ * never returned by a successful allocation.
+ *
+ * This library is not thread safe.
+ *
+ * Configuration options:
+ *
+ * - POOL_REALLOC (default realloc(3)): specify the allocator. If using a custom
+ *   allocator, must also specify POOL_FREE.
+ *
+ * - POOL_FREE (default free(3)): specify the deallocator. If using a custom
+ *   deallocator, must also specify POOL_REALLOC.
+ *
+ *
+ * API Functions:
+ *
+ * The following documentation takes this generated pool for instance:
+ * POOL_DECLARE(Pool, pool, SampleType)
+ *
+ * void pool_init(Pool *pool)
+ *   Initialize an empty pool. Optional if the pool's memory is zero-ed out.
+ *
+ * void pool_free(Pool *pool)
+ *   Deallocate every chunk. Objects are not finalized, every handle and pointer
+ *   to the pool becomes invalid.
+ *
+ * PoolHandle pool_alloc(Pool *pool)
+ *   Allocate a zero-ed object. Return POOL_NULL_HANDLE if the pool already
+ *   holds POOL_MAX_OBJECTS objects. O(1) amortized complexity.
+ *
+ * bool pool_release(Pool *pool, PoolHandle handle)
+ *   Return the object's slot to the pool. Return false if the handle is stale.
+ *
+ * SampleType *pool_get(const Pool *pool, PoolHandle handle)
+ *   Return the object behind the handle, or NULL if the handle is stale.
+ *
+ * bool pool_is_valid(const Pool *pool, PoolHandle handle)
+ *   Return whether the handle refers to an allocated object.
+ *
+ * PoolHandle pool_handle_of(const Pool *pool, const SampleType *item)
+ *   Return the handle of an allocated object from its address, or
+ *   POOL_NULL_HANDLE if it does not belong to the pool or was released.
+ *   O(chunk count) complexity.
+ *
+ * SampleType *pool_next(const Pool *pool, uint32_t *cursor)
+ *   Iterate over allocated objects. Start with `*cursor = 0`, returns NULL once
+ *   every object has been visited.
+ *
+ *
+ * Example:
+ *  POOL_DECLARE(IntPool, int_pool, int)
+ *  POOL_DEFINE(IntPool, int_pool, int)
+ *
+ *  IntPool pool = {0};
+ *  PoolHandle handle = int_pool_alloc(&pool);
+ *  *int_pool_get(&pool, handle) = 42;
+ *  int_pool_release(&pool, handle);
+ *  assert(int_pool_get(&pool, handle) == NULL);
+ *  int_pool_free(&pool);
+ */
+
+#if defined(POOL_REALLOC) && !defined(POOL_FREE) || \
+	!defined(POOL_REALLOC) && defined(POOL_FREE)
+#error "You must define both POOL_REALLOC and POOL_FREE, or neither."
+#endif
+#if !defined(POOL_REALLOC) && !defined(POOL_FREE)
+#define POOL_REALLOC(p, s) (realloc((p), (s)))
+#define POOL_FREE(p) (free((p)))
+#endif
+
+typedef uint32_t PoolHandle;
+
+enum {
+	POOL_CHUNK_SIZE = 64,
+	POOL_INDEX_BITS = 20,
+};
+
+#define POOL_NULL_HANDLE ((PoolHandle)0)
+#define POOL_INDEX_MASK ((1u << POOL_INDEX_BITS) - 1u)
+#define POOL_GENERATION_MASK ((1u << (32 - POOL_INDEX_BITS)) - 1u)
+/* The last index is reserved as the end of the free list */
+#define POOL_MAX_OBJECTS POOL_INDEX_MASK
+#define POOL_HANDLE_INDEX(handle) ((handle) & POOL_INDEX_MASK)
+#define POOL_HANDLE_GENERATION(handle) ((handle) >> POOL_INDEX_BITS)
+#define POOL_MAKE_HANDLE(index, generation)\
+	((PoolHandle)(((uint32_t)(generation) << POOL_INDEX_BITS) | (index)))
+
+#define POOL_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Type_)\
+\
+typedef struct Struct_Name_##Chunk {\
+	Custom_Type_ items[POOL_CHUNK_SIZE];\
+	uint32_t nextFree[POOL_CHUNK_SIZE];\
+	uint16_t generation[POOL_CHUNK_SIZE];\
+	bool alive[POOL_CHUNK_SIZE];\
+} Struct_Name_##Chunk;\
+\
+typedef struct Struct_Name_ {\
+	Struct_Name_##Chunk **chunks;\
+	uint32_t chunkCount;\
+	uint32_t chunkCapacity;\
+	/* Index + 1 of the first free slot, 0 when no slot is free */\
+	uint32_t freeHead;\
+	uint32_t count;\
+} Struct_Name_;\
+\
+void Functions_Prefix_##_init(Struct_Name_ *pool);\
+void Functions_Prefix_##_free(Struct_Name_ *pool);\
+PoolHandle Functions_Prefix_##_alloc(Struct_Name_ *pool);\
+bool Functions_Prefix_##_release(Struct_Name_ *pool, PoolHandle handle);\
+Custom_Type_ *Functions_Prefix_##_get(const Struct_Name_ *pool, PoolHandle handle);\
+bool Functions_Prefix_##_is_valid(const Struct_Name_ *pool, PoolHandle handle);\
+PoolHandle Functions_Prefix_##_handle_of(const Struct_Name_ *pool, const Custom_Type_ *item);\
+Custom_Type_ *Functions_Prefix_##_next(const Struct_Name_ *pool, uint32_t *cursor);
+
+#define POOL_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Type_)\
+\
+static void Functions_Prefix_##_grow(Struct_Name_ *pool)\
+{\
+	Struct_Name_##Chunk *chunk = NULL;\
+	uint32_t base = pool->chunkCount * POOL_CHUNK_SIZE;\
+\
+	if (pool->chunkCount == pool->chunkCapacity) {\
+		uint32_t capacity = pool->chunkCapacity ? pool->chunkCapacity * 2 : 4;\
+		Struct_Name_##Chunk **chunks = POOL_REALLOC(pool->chunks,\
+			capacity * sizeof(Struct_Name_##Chunk*));\
+		if (chunks == NULL) {\
+			(void)fprintf(stderr, "Out of memory. Panic.\n");\
+			abort();\
+		}\
+		pool->chunks = chunks;\
+		pool->chunkCapacity = capacity;\
+	}\
+\
+	chunk = POOL_REALLOC(NULL, sizeof(Struct_Name_##Chunk));\
+	if (chunk == NULL) {\
+		(void)fprintf(stderr, "Out of memory. Panic.\n");\
+		abort();\
+	}\
+	memset(chunk, 0, sizeof(Struct_Name_##Chunk));\
+\
+	for (uint32_t i = 0; i < POOL_CHUNK_SIZE; i++) {\
+		chunk->generation[i] = 1;\
+		chunk->nextFree[i] = base + i + 2;\
+	}\
+	chunk->nextFree[POOL_CHUNK_SIZE - 1] = pool->freeHead;\
+\
+	pool->chunks[pool->chunkCount] = chunk;\
+	pool->chunkCount++;\
+	pool->freeHead = base + 1;\
+}\
+\
+void Functions_Prefix_##_init(Struct_Name_ *pool)\
+{\
+	assert(pool != NULL);\
+\
+	memset(pool, 0, sizeof(Struct_Name_));\
+}\
+\
+void Functions_Prefix_##_free(Struct_Name_ *pool)\
+{\
+	assert(pool != NULL);\
+\
+	for (uint32_t i = 0; i < pool->chunkCount; i++) {\
+		POOL_FREE(pool->chunks[i]);\
+	}\
+	POOL_FREE(pool->chunks);\
+\
+	Functions_Prefix_##_init(pool);\
+}\
+\
+PoolHandle Functions_Prefix_##_alloc(Struct_Name_ *pool)\
+{\
+	assert(pool != NULL);\
+\
+	if (pool->freeHead == 0) {\
+		if ((pool->chunkCount + 1) * POOL_CHUNK_SIZE > POOL_MAX_OBJECTS) {\
+			return POOL_NULL_HANDLE;\
+		}\
+		Functions_Prefix_##_grow(pool);\
+	}\
+\
+	uint32_t index = pool->freeHead - 1;\
+	Struct_Name_##Chunk *chunk = pool->chunks[index / POOL_CHUNK_SIZE];\
+	uint32_t slot = index % POOL_CHUNK_SIZE;\
+\
+	assert(!chunk->alive[slot]);\
+\
+	pool->freeHead = chunk->nextFree[slot];\
+	memset(&chunk->items[slot], 0, sizeof(Custom_Type_));\
+	chunk->alive[slot] = true;\
+	pool->count++;\
+\
+	return POOL_MAKE_HANDLE(index, chunk->generation[slot]);\
+}\
+\
+bool Functions_Prefix_##_is_valid(const Struct_Name_ *pool, PoolHandle handle)\
+{\
+	assert(pool != NULL);\
+\
+	uint32_t index = POOL_HANDLE_INDEX(handle);\
+	if (index / POOL_CHUNK_SIZE >= pool->chunkCount) {\
+		return false;\
+	}\
+\
+	const Struct_Name_##Chunk *chunk = pool->chunks[index / POOL_CHUNK_SIZE];\
+	uint32_t slot = index % POOL_CHUNK_SIZE;\
+\
+	return chunk->alive[slot]\
+		&& chunk->generation[slot] == POOL_HANDLE_GENERATION(handle);\
+}\
+\
+bool Functions_Prefix_##_release(Struct_Name_ *pool, PoolHandle handle)\
+{\
+	if (!Functions_Prefix_##_is_valid(pool, handle)) {\
+		return false;\
+	}\
+\
+	uint32_t index = POOL_HANDLE_INDEX(handle);\
+	Struct_Name_##Chunk *chunk = pool->chunks[index / POOL_CHUNK_SIZE];\
+	uint32_t slot = index % POOL_CHUNK_SIZE;\
+\
+	chunk->alive[slot] = false;\
+	chunk->generation[slot] = (chunk->generation[slot] + 1) & POOL_GENERATION_MASK;\
+	/* Generation 0 is reserved so that POOL_NULL_HANDLE is never valid */\
+	if (chunk->generation[slot] == 0) {\
+		chunk->generation[slot] = 1;\
+	}\
+	chunk->nextFree[slot] = pool->freeHead;\
+	pool->freeHead = index + 1;\
+	pool->count--;\
+\
+	return true;\
+}\
+\
+Custom_Type_ *Functions_Prefix_##_get(const Struct_Name_ *pool, PoolHandle handle)\
+{\
+	if (!Functions_Prefix_##_is_valid(pool, handle)) {\
+		return NULL;\
+	}\
+\
+	uint32_t index = POOL_HANDLE_INDEX(handle);\
+	return &pool->chunks[index / POOL_CHUNK_SIZE]->items[index % POOL_CHUNK_SIZE];\
+}\
+\
+PoolHandle Functions_Prefix_##_handle_of(const Struct_Name_ *pool, const Custom_Type_ *item)\
+{\
+	assert(pool != NULL);\
+\
+	uintptr_t address = (uintptr_t)item;\
+\
+	for (uint32_t i = 0; i < pool->chunkCount; i++) {\
+		const Struct_Name_##Chunk *chunk = pool->chunks[i];\
+		uintptr_t begin = (uintptr_t)chunk->items;\
+		uintptr_t end = begin + sizeof(chunk->items);\
+\
+		/* Check for out of range or unaligned */\
+		if (address < begin || address >= end\
+		    || (address - begin) % sizeof(Custom_Type_) != 0) {\
+			continue;\
+		}\
+\
+		uint32_t slot = (uint32_t)((address - begin) / sizeof(Custom_Type_));\
+		if (!chunk->alive[slot]) {\
+			return POOL_NULL_HANDLE;\
+		}\
+\
+		return POOL_MAKE_HANDLE(i * POOL_CHUNK_SIZE + slot,\
+					chunk->generation[slot]);\
+	}\
+\
+	return POOL_NULL_HANDLE;\
+}\
+\
+Custom_Type_ *Functions_Prefix_##_next(const Struct_Name_ *pool, uint32_t *cursor)\
+{\
+	assert(pool != NULL);\
+	assert(cursor != NULL);\
+\
+	for (; *cursor < pool->chunkCount * POOL_CHUNK_SIZE; (*cursor)++) {\
+		Struct_Name_##Chunk *chunk = pool->chunks[*cursor / POOL_CHUNK_SIZE];\
+		uint32_t slot = *cursor % POOL_CHUNK_SIZE;\
+\
+		if (chunk->alive[slot]) {\
+			(*cursor)++;\
+			return &chunk->items[slot];\
+		}\
+	}\
+\
+	return NULL;\
+}
+
+/****************************************************************************
+ * Copyright (C) 2026 by Roland Marchand <roland.marchand@protonmail.com>   *
+ *                                                                          *
+ * Permission to use, copy, modify, and/or distribute this software for any *
+ * purpose with or without fee is hereby granted.                           *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED “AS IS” AND THE AUTHOR DISCLAIMS ALL WARRANTIES *
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR  *
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES   *
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN    *
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF  *
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.           *
+ ****************************************************************************/
+
+#endif /* POOL_H */
@@ -0,0 +1,190 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profiler.h"
+
+/* Trace thread ids */
+enum {
+	TRACE_TID_MAIN = 1,
+	TRACE_TID_SIMULATION = 2,
+	/* Span threads, numbered from 1 by laz_utils.h */
+	TRACE_TID_SPANS = 100,
+};
+
+struct ProfileEvent {
+	u64 start;
+	u64 duration;
+	ProfileZone zone;
+};
+
+struct ProfileFrame {
+	u64 durations[PROFILE_ZONE_FRAME_MAX];
+	/* Zones that ran during the frame, one bit each */
+	u32 ran;
+};
+
+/* The finished frames and the current one */
+#define PROFILER_FRAME_SLOTS (PROFILER_FRAME_COUNT + 1)
+
+struct Profiler {
+	struct ProfileFrame frames[PROFILER_FRAME_SLOTS];
+	/* Frames started so far, the current one is the last */
+	u64 frameCount;
+	struct ProfileEvent events[PROFILER_EVENT_COUNT];
+	/* Events recorded so far, the oldest ones were overwritten */
+	u64 eventCount;
+};
+
+_Static_assert(PROFILE_ZONE_FRAME_MAX <= sizeof(u32) * 8,
+	       "ProfileFrame.ran cannot hold every per-frame zone");
+
+static struct Profiler profiler;
+
+static int compareU64(const void *a, const void *b)
+{
+	u64 left = *(const u64 *)a;
+	u64 right = *(const u64 *)b;
+
+	return (left > right) - (left < right);
+}
+
+void initProfiler(void)
+{
+	memset(&profiler, 0, sizeof(profiler));
+}
+
+void profilerNextFrame(void)
+{
+	profiler.frameCount++;
+	memset(&profiler.frames[profiler.frameCount % PROFILER_FRAME_SLOTS], 0,
+	       sizeof(struct ProfileFrame));
+}
+
+u64 profilerBegin(void)
+{
+	return get_nanoseconds();
+}
+
+void profilerEnd(ProfileZone zone, u64 start)
+{
+	u64 now = get_nanoseconds();
+
+	profilerRecord(zone, start, now > start ? now - start : 0);
+}
+
+void profilerRecord(ProfileZone zone, u64 start, u64 duration)
+{
+	assert(zone < PROFILE_ZONE_MAX);
+
+	profiler.events[profiler.eventCount++ % PROFILER_EVENT_COUNT] =
+		(struct ProfileEvent) { start, duration, zone };
+
+	if (zone < PROFILE_ZONE_FRAME_MAX) {
+		struct ProfileFrame *frame =
+			&profiler.frames[profiler.frameCount % PROFILER_FRAME_SLOTS];
+		/* A zone that runs several times in a frame adds up */
+		frame->durations[zone] += duration;
+		frame->ran |= 1u << zone;
+	}
+}
+
+struct ProfileStats profilerStats(ProfileZone zone)
+{
+	assert(zone < PROFILE_ZONE_FRAME_MAX);
+
+	u64 samples[PROFILER_FRAME_COUNT];
+	struct ProfileStats stats = { 0 };
+	size_t frameCount = MIN(profiler.frameCount, PROFILER_FRAME_COUNT);
+
+	for (size_t i = 1; i <= frameCount; i++) {
+		const struct ProfileFrame *frame = &profiler.frames[
+			(profiler.frameCount - i) % PROFILER_FRAME_SLOTS];
+		if (frame->ran & (1u << zone)) {
+			samples[stats.sampleCount++] = frame->durations[zone];
+		}
+	}
+
+	if (stats.sampleCount == 0) {
+		return stats;
+	}
+
+	qsort(samples, stats.sampleCount, sizeof(u64), compareU64);
+	stats.p50 = samples[(stats.sampleCount - 1) / 2];
+	stats.p99 = samples[(stats.sampleCount - 1) * 99 / 100];
+	stats.max = samples[stats.sampleCount - 1];
+
+	return stats;
+}
+
+/* Spans of `laz_trace_foreach()`, after the profiler's own events */
+static void writeSpan(const struct laz_span *span, u32 thread, void *ctx)
+{
+	FILE *file = ctx;
+
+	fprintf(file,
+		",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+		"\"ts\":%.3f,\"dur\":%.3f}\n",
+		span->name,
+		(unsigned)(TRACE_TID_SPANS + thread),
+		(double)span->start / 1000.0,
+		(double)(span->end - span->start) / 1000.0);
+}
+
+Error profilerDumpTrace(const char *path)
+{
+	assert(path != NULL);
+
+	FILE *file = fopen(path, "w");
+	if (file == NULL) {
+		return ERR_FILE_WRITING_FAILED;
+	}
+
+	u64 first = profiler.eventCount > PROFILER_EVENT_COUNT ?
+		profiler.eventCount - PROFILER_EVENT_COUNT : 0;
+
+	/* Metadata first, so every event after it starts with a comma */
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+		"\"args\":{\"name\":\"game\"}}\n");
+	for (u64 i = first; i < profiler.eventCount; i++) {
+		const struct ProfileEvent *event =
+			&profiler.events[i % PROFILER_EVENT_COUNT];
+		int tid = event->zone == PROFILE_ZONE_SIMULATION ?
+			TRACE_TID_SIMULATION : TRACE_TID_MAIN;
+
+		/* Complete events, timestamps in microseconds */
+		fprintf(file,
+			",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+			"\"ts\":%.3f,\"dur\":%.3f}\n",
+			profileZoneToString(event->zone),
+			tid,
+			(double)event->start / 1000.0,
+			(double)event->duration / 1000.0);
+	}
+	laz_trace_foreach(writeSpan, file);
+	fprintf(file, "]}\n");
+
+	if (fclose(file) != 0) {
+		return ERR_FILE_WRITING_FAILED;
+	}
+
+	return ERR_OK;
+}
+
+const char *profileZoneToString(ProfileZone zone)
+{
+	switch (zone) {
+	case PROFILE_ZONE_FRAME: return "frame";
+	case PROFILE_ZONE_VIEW: return "view";
+	case PROFILE_ZONE_LAYOUT: return "layout";
+	case PROFILE_ZONE_END_LAYOUT: return "end layout";
+	case PROFILE_ZONE_RENDER: return "render";
+	case PROFILE_ZONE_SIMULATION: return "simulation";
+	case PROFILE_ZONE_INIT: return "init";
+	case PROFILE_ZONE_GAME_LOOP: return "game loop";
+	case PROFILE_ZONE_CLEANUP: return "cleanup";
+	default: return "unknown";
+	}
+}
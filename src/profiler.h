@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "common.h"
+
+/* Frame profiler. Zones are timed with `profilerBegin()`/`profilerEnd()`,
+ * their time per frame is kept for the last PROFILER_FRAME_COUNT frames for
+ * percentiles, and each timed run is kept as an event for the last
+ * PROFILER_EVENT_COUNT events for traces. Main thread only, other threads
+ * report their timings through the main thread with `profilerRecord()`. */
+
+#define PROFILER_FRAME_COUNT 256
+#define PROFILER_EVENT_COUNT 8192
+#define PROFILER_TRACE_FILE "trace.json"
+
+typedef enum ProfileZone {
+	/* Measured every frame, with percentiles */
+	PROFILE_ZONE_FRAME = 0,
+	PROFILE_ZONE_VIEW,
+	PROFILE_ZONE_LAYOUT,
+	PROFILE_ZONE_END_LAYOUT,
+	PROFILE_ZONE_RENDER,
+	/* Simulation ticks, reported by the main thread as frames see them */
+	PROFILE_ZONE_SIMULATION,
+	PROFILE_ZONE_FRAME_MAX,
+	/* Once per run, only in traces */
+	PROFILE_ZONE_INIT = PROFILE_ZONE_FRAME_MAX,
+	PROFILE_ZONE_GAME_LOOP,
+	PROFILE_ZONE_CLEANUP,
+	PROFILE_ZONE_MAX,
+} ProfileZone;
+
+/* In nanoseconds, over the frames in which the zone ran */
+struct ProfileStats {
+	u64 p50;
+	u64 p99;
+	u64 max;
+	size_t sampleCount;
+};
+
+void initProfiler(void);
+/* Start a new frame, the per-frame time of every zone restarts at 0 */
+void profilerNextFrame(void);
+/* Return the start time to pass to `profilerEnd()` */
+u64 profilerBegin(void);
+void profilerEnd(ProfileZone zone, u64 start);
+/* Add a timing measured elsewhere, `start` from get_nanoseconds() */
+void profilerRecord(ProfileZone zone, u64 start, u64 duration);
+struct ProfileStats profilerStats(ProfileZone zone);
+/* Write the kept events, and the spans traced with laz_utils.h, to `path` in
+ * Chrome's trace event format, for chrome://tracing or Perfetto */
+Error profilerDumpTrace(const char *path);
+const char *profileZoneToString(ProfileZone zone);
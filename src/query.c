@@ -0,0 +1,179 @@
+#include <assert.h>
+
+#include "query.h"
+#include "simd.h"
+
+/* Entities compared per iteration, one bit each in the block's mask */
+#if SIMD_AVX2
+#define QUERY_BLOCK 32
+#else
+#define QUERY_BLOCK 16
+#endif
+
+_Static_assert(ENTITY_CHUNK_SIZE % QUERY_BLOCK == 0,
+	       "ENTITY_CHUNK_SIZE must be a multiple of the query block size");
+
+#if SIMD_AVX2
+static u32 matchBlock(
+	const struct EntityChunk *c,
+	const struct EntityQuery *q,
+	size_t base
+)
+{
+	__m256i types = _mm256_loadu_si256((const __m256i *)&c->types[base]);
+	__m256i all = _mm256_set1_epi8((char)q->allTypes);
+	__m256i match = _mm256_cmpeq_epi8(_mm256_and_si256(types, all), all);
+
+	if (q->anyTypes != 0) {
+		__m256i any = _mm256_set1_epi8((char)q->anyTypes);
+		__m256i none = _mm256_cmpeq_epi8(_mm256_and_si256(types, any),
+						 _mm256_setzero_si256());
+		match = _mm256_andnot_si256(none, match);
+	}
+
+	if (q->room != 0) {
+		__m256i room = _mm256_set1_epi16((short)q->room);
+		__m256i lo = _mm256_cmpeq_epi16(room, _mm256_loadu_si256(
+			(const __m256i *)&c->location[base]));
+		__m256i hi = _mm256_cmpeq_epi16(room, _mm256_loadu_si256(
+			(const __m256i *)&c->location[base + 16]));
+		/* Packing works per 128-bit lane, put the quarters back in
+		 * entity order */
+		__m256i packed = _mm256_permute4x64_epi64(
+			_mm256_packs_epi16(lo, hi), 0xD8);
+		match = _mm256_and_si256(match, packed);
+	}
+
+	if (q->minHealth > QUERY_ANY_HEALTH) {
+		__m256 min = _mm256_set1_ps(q->minHealth);
+		__m256i h[4];
+		for (int i = 0; i < 4; i++) {
+			__m256 health = _mm256_loadu_ps(&c->healths[base + 8 * i]);
+			h[i] = _mm256_castps_si256(
+				_mm256_cmp_ps(health, min, _CMP_GT_OQ));
+		}
+		__m256i packed = _mm256_packs_epi16(
+			_mm256_packs_epi32(h[0], h[1]),
+			_mm256_packs_epi32(h[2], h[3]));
+		packed = _mm256_permutevar8x32_epi32(
+			packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+		match = _mm256_and_si256(match, packed);
+	}
+
+	return (u32)_mm256_movemask_epi8(match);
+}
+#elif SIMD_SSE2
+static u32 matchBlock(
+	const struct EntityChunk *c,
+	const struct EntityQuery *q,
+	size_t base
+)
+{
+	__m128i types = _mm_loadu_si128((const __m128i *)&c->types[base]);
+	__m128i all = _mm_set1_epi8((char)q->allTypes);
+	__m128i match = _mm_cmpeq_epi8(_mm_and_si128(types, all), all);
+
+	if (q->anyTypes != 0) {
+		__m128i any = _mm_set1_epi8((char)q->anyTypes);
+		__m128i none = _mm_cmpeq_epi8(_mm_and_si128(types, any),
+					      _mm_setzero_si128());
+		match = _mm_andnot_si128(none, match);
+	}
+
+	if (q->room != 0) {
+		__m128i room = _mm_set1_epi16((short)q->room);
+		__m128i lo = _mm_cmpeq_epi16(room, _mm_loadu_si128(
+			(const __m128i *)&c->location[base]));
+		__m128i hi = _mm_cmpeq_epi16(room, _mm_loadu_si128(
+			(const __m128i *)&c->location[base + 8]));
+		match = _mm_and_si128(match, _mm_packs_epi16(lo, hi));
+	}
+
+	if (q->minHealth > QUERY_ANY_HEALTH) {
+		__m128 min = _mm_set1_ps(q->minHealth);
+		__m128i h[4];
+		for (int i = 0; i < 4; i++) {
+			__m128 health = _mm_loadu_ps(&c->healths[base + 4 * i]);
+			h[i] = _mm_castps_si128(_mm_cmpgt_ps(health, min));
+		}
+		__m128i packed = _mm_packs_epi16(_mm_packs_epi32(h[0], h[1]),
+						 _mm_packs_epi32(h[2], h[3]));
+		match = _mm_and_si128(match, packed);
+	}
+
+	return (u32)_mm_movemask_epi8(match);
+}
+#else
+static u32 matchBlock(
+	const struct EntityChunk *c,
+	const struct EntityQuery *q,
+	size_t base
+)
+{
+	u32 mask = 0;
+
+	for (size_t i = 0; i < QUERY_BLOCK; i++) {
+		EntityType types = c->types[base + i];
+		bool match = (types & q->allTypes) == q->allTypes
+			&& (q->anyTypes == 0 || (types & q->anyTypes) != 0)
+			&& (q->room == 0 || c->location[base + i] == q->room)
+			&& (!(q->minHealth > QUERY_ANY_HEALTH)
+			    || c->healths[base + i] > q->minHealth);
+
+		mask |= (u32)match << i;
+	}
+
+	return mask;
+}
+#endif
+
+size_t entityQueryChunk(
+	const struct EntityComponents *components,
+	u16 chunk,
+	const struct EntityQuery *query,
+	EntityIdx out[ENTITY_CHUNK_SIZE]
+)
+{
+	assert(components != NULL);
+	assert(chunk < components->chunkCount);
+	assert(query != NULL);
+	assert(out != NULL);
+
+	const struct EntityChunk *c = components->chunks[chunk];
+	size_t first = (size_t)chunk * ENTITY_CHUNK_SIZE;
+	size_t count = 0;
+
+	for (size_t base = 0; base < ENTITY_CHUNK_SIZE; base += QUERY_BLOCK) {
+		u32 mask = matchBlock(c, query, base);
+
+		/* Entity 0 is the null entity */
+		if (first + base == 0) {
+			mask &= ~1u;
+		}
+
+		while (mask != 0) {
+			out[count++] = (EntityIdx)(first + base
+						   + (size_t)simdLowestBit(mask));
+			mask &= mask - 1;
+		}
+	}
+
+	return count;
+}
+
+size_t entityQuery(
+	const struct EntityComponents *components,
+	const struct EntityQuery *query,
+	EntityIdx *out
+)
+{
+	assert(components != NULL);
+
+	size_t count = 0;
+
+	for (u16 chunk = 0; chunk < components->chunkCount; chunk++) {
+		count += entityQueryChunk(components, chunk, query, out + count);
+	}
+
+	return count;
+}
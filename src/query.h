@@ -0,0 +1,39 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+
+#include "common.h"
+#include "entity.h"
+#include "room.h"
+
+/* Health filter that accepts every entity */
+#define QUERY_ANY_HEALTH (-INFINITY)
+
+/* Entities match when they have at least one of `anyTypes` (0 for any type),
+ * all of `allTypes`, are in `room` (0 for any room) and have a health strictly
+ * above `minHealth`. */
+struct EntityQuery {
+	EntityType anyTypes;
+	EntityType allTypes;
+	RoomIdx room;
+	float minHealth;
+};
+
+/* Write the matching entities to `out`, which has room for every entity of
+ * `components`, in increasing order and return how many matched. The columns
+ * are compared 16 or 32 entities at a time with SSE2 or AVX2 when the compiler
+ * targets them, and one at a time otherwise. Entity 0 never matches. */
+size_t entityQuery(
+	const struct EntityComponents *components,
+	const struct EntityQuery *query,
+	EntityIdx *out
+);
+/* The part of `entityQuery()` over one chunk, chunks can be queried in
+ * parallel */
+size_t entityQueryChunk(
+	const struct EntityComponents *components,
+	u16 chunk,
+	const struct EntityQuery *query,
+	EntityIdx out[ENTITY_CHUNK_SIZE]
+);
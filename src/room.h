@@ -2,12 +2,16 @@
 
 #include "laz_utils.h"
 #include "graph.h"
+#include "intern.h"
 
 #define MAX_ROOMS 128
 
+/* Rooms are the nodes of `struct Rooms.layout`, room 0 is nowhere */
+typedef GraphNodeIdx RoomIdx;
+
 struct Rooms {
-	char *names[MAX_ROOMS];
-	char *descriptions[MAX_ROOMS];
+	Symbol names[MAX_ROOMS];
+	Symbol descriptions[MAX_ROOMS];
 	u16 depth[MAX_ROOMS];
 	struct Graph layout;
 };
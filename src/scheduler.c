@@ -0,0 +1,239 @@
+#include <assert.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define SCHEDULER_HAVE_SYSCONF
+#endif
+
+#include "scheduler.h"
+#include "simd.h"
+
+_Static_assert(MAX_SYSTEMS <= sizeof(u32) * 8,
+	       "Scheduler masks cannot hold MAX_SYSTEMS systems");
+
+static bool systemsConflict(const struct System *a, const struct System *b)
+{
+	return (a->writes & (b->reads | b->writes)) != 0 ||
+	       (b->writes & a->reads) != 0;
+}
+
+/* A system waits for every system registered before it that it conflicts
+ * with, registration order is the only rule. Systems that don't conflict get
+ * no edge, main thread systems included: those only run one after the other
+ * because they share the calling thread. */
+static void buildGraph(struct Scheduler *scheduler)
+{
+	memset(scheduler->dependents, 0, sizeof(scheduler->dependents));
+	memset(scheduler->waitingFor, 0, sizeof(scheduler->waitingFor));
+
+	for (u32 later = 0; later < scheduler->systemCount; later++) {
+		for (u32 earlier = 0; earlier < later; earlier++) {
+			if (systemsConflict(&scheduler->systems[earlier],
+					    &scheduler->systems[later])) {
+				scheduler->dependents[earlier] |= 1u << later;
+				scheduler->waitingFor[later]++;
+			}
+		}
+	}
+}
+
+static u32 mainThreadSystems(const struct Scheduler *scheduler)
+{
+	u32 mask = 0;
+
+	for (u32 i = 0; i < scheduler->systemCount; i++) {
+		if (scheduler->systems[i].flags & SYSTEM_MAIN_THREAD) {
+			mask |= 1u << i;
+		}
+	}
+
+	return mask;
+}
+
+/* Take a ready system among `allowed`, with the lock held. Returns false when
+ * none is ready. */
+static bool takeSystem(struct Scheduler *scheduler, u32 allowed, u32 *out)
+{
+	u32 candidates = scheduler->ready & allowed;
+	if (candidates == 0) {
+		return false;
+	}
+
+	*out = (u32)simdLowestBit(candidates);
+	scheduler->ready &= ~(1u << *out);
+	return true;
+}
+
+/* Run a taken system without the lock, then release its dependents */
+static void runSystem(struct Scheduler *scheduler, u32 system)
+{
+	Error err = ERR_OK;
+
+	mtx_lock(&scheduler->lock);
+	bool skip = scheduler->error != ERR_OK;
+	mtx_unlock(&scheduler->lock);
+
+	if (!skip) {
+		u64 start = laz_trace_begin();
+		err = scheduler->systems[system].run(scheduler->world);
+		laz_trace_end(scheduler->systems[system].name, start);
+	}
+
+	mtx_lock(&scheduler->lock);
+	if (err != ERR_OK && scheduler->error == ERR_OK) {
+		scheduler->error = err;
+	}
+
+	u32 dependents = scheduler->dependents[system];
+	while (dependents != 0) {
+		u32 dependent = (u32)simdLowestBit(dependents);
+		dependents &= dependents - 1;
+		if (--scheduler->waitingFor[dependent] == 0) {
+			scheduler->ready |= 1u << dependent;
+		}
+	}
+
+	scheduler->finished |= 1u << system;
+	scheduler->pending--;
+	cnd_broadcast(&scheduler->changed);
+	mtx_unlock(&scheduler->lock);
+}
+
+static int workerMain(void *arg)
+{
+	struct Scheduler *scheduler = arg;
+	initThreadArena();
+
+	mtx_lock(&scheduler->lock);
+	while (!scheduler->stopping) {
+		u32 system;
+		if (!takeSystem(scheduler, ~mainThreadSystems(scheduler), &system)) {
+			cnd_wait(&scheduler->changed, &scheduler->lock);
+			continue;
+		}
+
+		mtx_unlock(&scheduler->lock);
+		runSystem(scheduler, system);
+		/* Worker allocations only live as long as the system's run */
+		resetThreadArena();
+		mtx_lock(&scheduler->lock);
+	}
+	mtx_unlock(&scheduler->lock);
+
+	cleanupThreadArena();
+	return 0;
+}
+
+Error schedulerInit(struct Scheduler *scheduler, u32 workerCount)
+{
+	assert(scheduler != NULL);
+	assert(workerCount <= MAX_WORKERS);
+
+	memset(scheduler, 0, sizeof(struct Scheduler));
+
+	if (mtx_init(&scheduler->lock, mtx_plain) != thrd_success) {
+		return ERR_THREAD_CREATION_FAILED;
+	}
+	if (cnd_init(&scheduler->changed) != thrd_success) {
+		mtx_destroy(&scheduler->lock);
+		return ERR_THREAD_CREATION_FAILED;
+	}
+
+	for (u32 i = 0; i < workerCount; i++) {
+		if (thrd_create(&scheduler->workers[i], workerMain, scheduler)
+		    != thrd_success) {
+			schedulerCleanup(scheduler);
+			return ERR_THREAD_CREATION_FAILED;
+		}
+		scheduler->workerCount++;
+	}
+
+	return ERR_OK;
+}
+
+void schedulerCleanup(struct Scheduler *scheduler)
+{
+	assert(scheduler != NULL);
+
+	mtx_lock(&scheduler->lock);
+	scheduler->stopping = true;
+	cnd_broadcast(&scheduler->changed);
+	mtx_unlock(&scheduler->lock);
+
+	for (u32 i = 0; i < scheduler->workerCount; i++) {
+		thrd_join(scheduler->workers[i], NULL);
+	}
+	scheduler->workerCount = 0;
+
+	cnd_destroy(&scheduler->changed);
+	mtx_destroy(&scheduler->lock);
+}
+
+u32 schedulerDefaultWorkerCount(void)
+{
+#ifdef SCHEDULER_HAVE_SYSCONF
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cores > 1) {
+		return MIN((u32)cores - 1, MAX_WORKERS);
+	}
+#endif
+	return 0;
+}
+
+void schedulerAddSystem(struct Scheduler *scheduler, struct System system)
+{
+	assert(scheduler != NULL);
+	assert(scheduler->systemCount < MAX_SYSTEMS);
+	assert(system.run != NULL);
+
+	scheduler->systems[scheduler->systemCount++] = system;
+}
+
+Error schedulerRun(struct Scheduler *scheduler, struct World *world)
+{
+	assert(scheduler != NULL);
+	assert(world != NULL);
+
+	u32 mainThread = mainThreadSystems(scheduler);
+
+	mtx_lock(&scheduler->lock);
+	buildGraph(scheduler);
+	scheduler->world = world;
+	scheduler->error = ERR_OK;
+	scheduler->pending = scheduler->systemCount;
+	scheduler->ready = 0;
+	scheduler->finished = 0;
+	for (u32 i = 0; i < scheduler->systemCount; i++) {
+		if (scheduler->waitingFor[i] == 0) {
+			scheduler->ready |= 1u << i;
+		}
+	}
+	cnd_broadcast(&scheduler->changed);
+
+	while (scheduler->pending > 0) {
+		/* Once its own systems are done, or without workers, the calling
+		 * thread helps with the others rather than idling */
+		u32 allowed = mainThread;
+		if (scheduler->workerCount == 0 ||
+		    (mainThread & ~scheduler->finished) == 0) {
+			allowed = ~0u;
+		}
+
+		u32 system;
+		if (!takeSystem(scheduler, allowed, &system)) {
+			cnd_wait(&scheduler->changed, &scheduler->lock);
+			continue;
+		}
+
+		mtx_unlock(&scheduler->lock);
+		runSystem(scheduler, system);
+		mtx_lock(&scheduler->lock);
+	}
+
+	Error err = scheduler->error;
+	scheduler->world = NULL;
+	mtx_unlock(&scheduler->lock);
+
+	return err;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "common.h"
+#include "thread.h"
+#include "world.h"
+
+#define MAX_SYSTEMS 32
+#define MAX_WORKERS 8
+
+/* Parts of the world a system touches, one bit per column. Two systems
+ * conflict when one writes a column the other reads or writes. */
+typedef u32 ComponentMask;
+
+enum {
+	/* Entity allocator and chunk list, written when spawning entities */
+	COMPONENT_ENTITY_STORAGE = 1 << 0,
+	COMPONENT_HEALTHS = 1 << 1,
+	COMPONENT_MAX_HEALTHS = 1 << 2,
+	COMPONENT_DAMAGE_OVER_TIME = 1 << 3,
+	COMPONENT_REGENERATION = 1 << 4,
+	/* Location column and location index, see locationMove() */
+	COMPONENT_LOCATION = 1 << 5,
+	COMPONENT_TYPES = 1 << 6,
+	COMPONENT_NAMES = 1 << 7,
+	COMPONENT_DESCRIPTIONS = 1 << 8,
+	COMPONENT_NEWLY_DEAD = 1 << 9,
+	COMPONENT_ROOM_NAMES = 1 << 10,
+	COMPONENT_ROOM_DESCRIPTIONS = 1 << 11,
+	COMPONENT_ROOM_DEPTH = 1 << 12,
+	COMPONENT_ROOM_LAYOUT = 1 << 13,
+};
+
+typedef enum SystemFlags {
+	/* Runs on the thread calling schedulerRun(), for state that thread owns,
+	 * e.g. systems spawning entities or interning strings, which grow the
+	 * world's memory, see claimWorldMemory() */
+	SYSTEM_MAIN_THREAD = 1 << 0,
+} SystemFlags;
+
+typedef Error (*SystemFunc)(struct World *world);
+
+struct System {
+	const char *name;
+	SystemFunc run;
+	ComponentMask reads;
+	ComponentMask writes;
+	SystemFlags flags;
+};
+
+/* Runs the systems of a tick on a pool of worker threads and the calling
+ * thread. Every tick, a system waits for the earlier registered systems it
+ * conflicts with, so the result is the same as running them in registration
+ * order, and systems that don't conflict run concurrently. Systems returning
+ * an error stop the tick: systems that haven't started are skipped. */
+struct Scheduler {
+	struct System systems[MAX_SYSTEMS];
+	u32 systemCount;
+
+	/* Current tick's dependency graph, bit j of dependents[i] when system j
+	 * waits for system i */
+	u32 dependents[MAX_SYSTEMS];
+	u32 waitingFor[MAX_SYSTEMS];
+
+	/* Everything below is protected by `lock` */
+	mtx_t lock;
+	/* Broadcast when systems become ready or finish, or on stop */
+	cnd_t changed;
+	u32 ready;
+	u32 finished;
+	u32 pending;
+	Error error;
+	struct World *world;
+	bool stopping;
+
+	thrd_t workers[MAX_WORKERS];
+	u32 workerCount;
+};
+
+/* Start `workerCount` workers, at most MAX_WORKERS. With 0 workers, every
+ * system runs on the calling thread. */
+Error schedulerInit(struct Scheduler *scheduler, u32 workerCount);
+/* Stop and join the workers */
+void schedulerCleanup(struct Scheduler *scheduler);
+/* Workers for this machine: one per core besides the calling thread's */
+u32 schedulerDefaultWorkerCount(void);
+
+void schedulerAddSystem(struct Scheduler *scheduler, struct System system);
+/* Run every system once and return the first error. Returns once all systems
+ * are done. */
+Error schedulerRun(struct Scheduler *scheduler, struct World *world);
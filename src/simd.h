@@ -0,0 +1,45 @@
+#pragma once
+
+#include <assert.h>
+
+#include "laz_utils.h"
+
+/* Instruction sets the entity kernels are compiled for, picked at compile
+ * time from the compiler's target. Kernels keep a scalar fallback. */
+#if defined(__AVX2__)
+#define SIMD_AVX2 1
+#define SIMD_SSE2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) \
+	|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_AVX2 0
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define SIMD_AVX2 0
+#define SIMD_SSE2 0
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/* Index of the lowest set bit of a non-zero mask */
+static inline int simdLowestBit(u32 mask)
+{
+	assert(mask != 0);
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	int count = 0;
+	while ((mask & 1u) == 0) {
+		mask >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
@@ -0,0 +1,156 @@
+#include <assert.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "simulation.h"
+#include "thread.h"
+
+#define SIMULATION_TICK_SECONDS (1.0 / SIMULATION_TICK_RATE)
+
+struct Simulation {
+	thrd_t thread;
+	bool running;
+	atomic_bool stopping;
+	/* Error, set once by the simulation thread */
+	atomic_int status;
+	struct World *world;
+	struct Scheduler *scheduler;
+	struct SnapshotBuffer snapshots;
+	/* See simulationSetViewWake() */
+	_Atomic(SimulationWake) wakeView;
+};
+
+static struct Simulation simulation;
+
+static double secondsNow(void)
+{
+	return (double)get_nanoseconds() / 1e9;
+}
+
+static void sleepSeconds(double seconds)
+{
+	struct timespec duration = {
+		.tv_sec = (time_t)seconds,
+		.tv_nsec = (long)((seconds - (double)(time_t)seconds) * 1e9),
+	};
+	thrd_sleep(&duration, NULL);
+}
+
+static void wakeView(void)
+{
+	SimulationWake wake = atomic_load(&simulation.wakeView);
+	if (wake != NULL) {
+		wake();
+	}
+}
+
+static int simulationMain(void *arg)
+{
+	(void)arg;
+	struct World *world = simulation.world;
+	initThreadArena();
+	/* The world only grows on this thread until stopSimulation() */
+	claimWorldMemory();
+
+	double nextTick = secondsNow();
+	u64 tick = 0;
+	u64 deathCount = 0;
+	u16 entityCount = 0;
+
+	while (!atomic_load(&simulation.stopping)) {
+		double now = secondsNow();
+		if (now < nextTick) {
+			sleepSeconds(nextTick - now);
+			continue;
+		}
+
+		if (now - nextTick > SIMULATION_MAX_CATCH_UP * SIMULATION_TICK_SECONDS) {
+			nextTick = now;
+		}
+		nextTick += SIMULATION_TICK_SECONDS;
+
+		world->tickSeconds = (float)SIMULATION_TICK_SECONDS;
+		world->newlyDeadCount = 0;
+		u64 tickStart = get_nanoseconds();
+		Error err = schedulerRun(simulation.scheduler, world);
+		u64 tickDuration = get_nanoseconds() - tickStart;
+		resetThreadArena();
+		if (err != ERR_OK) {
+			atomic_store(&simulation.status, err);
+			wakeView();
+			break;
+		}
+
+		tick++;
+		deathCount += world->newlyDeadCount;
+
+		struct WorldSnapshot *snapshot =
+			snapshotBufferBack(&simulation.snapshots);
+		*snapshot = (struct WorldSnapshot) {
+			.tick = tick,
+			.gameSeconds = (double)tick * SIMULATION_TICK_SECONDS,
+			.entityCount = world->allocator.count,
+			.deathCount = deathCount,
+			.tickStart = tickStart,
+			.tickDuration = tickDuration,
+		};
+		snapshotBufferPublish(&simulation.snapshots);
+
+		/* Tick and game time change every tick, they don't count */
+		if (world->newlyDeadCount != 0
+		    || world->allocator.count != entityCount) {
+			entityCount = world->allocator.count;
+			wakeView();
+		}
+	}
+
+	cleanupThreadArena();
+	return 0;
+}
+
+Error startSimulation(struct World *world, struct Scheduler *scheduler)
+{
+	assert(world != NULL);
+	assert(scheduler != NULL);
+	assert(!simulation.running);
+
+	simulation.world = world;
+	simulation.scheduler = scheduler;
+	atomic_store(&simulation.stopping, false);
+	atomic_store(&simulation.status, ERR_OK);
+	snapshotBufferInit(&simulation.snapshots);
+
+	if (thrd_create(&simulation.thread, simulationMain, NULL) != thrd_success) {
+		return ERR_THREAD_CREATION_FAILED;
+	}
+	simulation.running = true;
+
+	return ERR_OK;
+}
+
+void stopSimulation(void)
+{
+	if (!simulation.running) {
+		return;
+	}
+
+	atomic_store(&simulation.stopping, true);
+	thrd_join(simulation.thread, NULL);
+	simulation.running = false;
+	claimWorldMemory();
+}
+
+Error simulationStatus(void)
+{
+	return (Error)atomic_load(&simulation.status);
+}
+
+const struct WorldSnapshot *simulationSnapshot(void)
+{
+	return snapshotBufferRead(&simulation.snapshots);
+}
+
+void simulationSetViewWake(SimulationWake wake)
+{
+	atomic_store(&simulation.wakeView, wake);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common.h"
+#include "scheduler.h"
+#include "snapshot.h"
+#include "world.h"
+
+/* Simulation ticks per second of game time */
+#define SIMULATION_TICK_RATE 30
+/* Ticks run back to back to catch up after a stall, time past that is dropped
+ * so the simulation doesn't fall further behind trying to catch up */
+#define SIMULATION_MAX_CATCH_UP 5
+
+/* Run `scheduler`'s systems on `world` at SIMULATION_TICK_RATE on a thread of
+ * its own, independently of the frame rate. Only the simulation thread
+ * touches `world` until `stopSimulation()`, the view reads snapshots. The
+ * simulation thread owns the world's memory meanwhile, see
+ * `claimWorldMemory()`. */
+Error startSimulation(struct World *world, struct Scheduler *scheduler);
+/* Finish the current tick and join the thread, the calling thread owns the
+ * world's memory again */
+void stopSimulation(void);
+/* The error that stopped the simulation, ERR_OK while it runs */
+Error simulationStatus(void);
+/* Latest snapshot, from the main thread only. Valid until the next call. */
+const struct WorldSnapshot *simulationSnapshot(void);
+
+/* Called on the simulation thread when the view should wake up from idle, so
+ * it must be thread safe */
+typedef void (*SimulationWake)(void);
+
+/* `wake` is called after the ticks that change what the view shows, the tick
+ * count and game time excepted, and when the simulation stops on an error.
+ * NULL disables it. */
+void simulationSetViewWake(SimulationWake wake);
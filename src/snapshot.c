@@ -0,0 +1,49 @@
+#include <assert.h>
+#include <string.h>
+
+#include "snapshot.h"
+
+#define SNAPSHOT_FRESH 4u
+#define SNAPSHOT_INDEX 3u
+
+void snapshotBufferInit(struct SnapshotBuffer *buffer)
+{
+	assert(buffer != NULL);
+
+	memset(buffer->buffers, 0, sizeof(buffer->buffers));
+	buffer->back = 0;
+	atomic_init(&buffer->middle, 1);
+	buffer->front = 2;
+}
+
+struct WorldSnapshot *snapshotBufferBack(struct SnapshotBuffer *buffer)
+{
+	assert(buffer != NULL);
+
+	return &buffer->buffers[buffer->back];
+}
+
+void snapshotBufferPublish(struct SnapshotBuffer *buffer)
+{
+	assert(buffer != NULL);
+
+	/* Release: the snapshot's content is visible before its index */
+	unsigned previous = atomic_exchange_explicit(&buffer->middle,
+		buffer->back | SNAPSHOT_FRESH, memory_order_acq_rel);
+	buffer->back = previous & SNAPSHOT_INDEX;
+}
+
+const struct WorldSnapshot *snapshotBufferRead(struct SnapshotBuffer *buffer)
+{
+	assert(buffer != NULL);
+
+	if (atomic_load_explicit(&buffer->middle, memory_order_relaxed)
+	    & SNAPSHOT_FRESH) {
+		/* Acquire: pairs with the release in `snapshotBufferPublish()` */
+		unsigned previous = atomic_exchange_explicit(&buffer->middle,
+			buffer->front, memory_order_acq_rel);
+		buffer->front = previous & SNAPSHOT_INDEX;
+	}
+
+	return &buffer->buffers[buffer->front];
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdatomic.h>
+
+#include "common.h"
+
+/* What the view knows of the world, copied out by the simulation thread at
+ * the end of each tick. Immutable once published. */
+struct WorldSnapshot {
+	u64 tick;
+	/* Game time simulated so far */
+	double gameSeconds;
+	u16 entityCount;
+	u64 deathCount;
+	/* When the tick started, from get_nanoseconds(), and how long it took */
+	u64 tickStart;
+	u64 tickDuration;
+};
+
+/* Hands snapshots from one writer thread to one reader thread without locks.
+ * Of the three buffers, the writer owns one, the reader owns one, and the
+ * last published one waits in the middle. Publishing swaps the writer's
+ * buffer with the middle one, reading swaps the reader's with it if it's
+ * newer, so neither ever waits and the reader always gets a whole snapshot,
+ * the latest one. */
+struct SnapshotBuffer {
+	struct WorldSnapshot buffers[3];
+	/* Index of the middle buffer, with SNAPSHOT_FRESH when it hasn't been
+	 * read yet */
+	atomic_uint middle;
+	/* Owned by the writer */
+	unsigned back;
+	/* Owned by the reader */
+	unsigned front;
+};
+
+void snapshotBufferInit(struct SnapshotBuffer *buffer);
+/* Writer: the buffer to fill before `snapshotBufferPublish()` */
+struct WorldSnapshot *snapshotBufferBack(struct SnapshotBuffer *buffer);
+void snapshotBufferPublish(struct SnapshotBuffer *buffer);
+/* Reader: the latest published snapshot, valid until the next call */
+const struct WorldSnapshot *snapshotBufferRead(struct SnapshotBuffer *buffer);
@@ -0,0 +1,345 @@
+#ifndef SPARSE_SET_H
+#define SPARSE_SET_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Library to generate type-safe sparse sets, for components only some entities
+ * have.
+ *
+ * To generate sparse sets, use the macros SPARSE_SET_DECLARE() to generate the
+ * header, and SPARSE_SET_DEFINE() to generate the source, the same way as
+ * POOL_DECLARE() and POOL_DEFINE() from pool_base.h.
+ *
+ * Values are packed in a dense array along with their key, so iterating over a
+ * set visits only its members. The sparse index from keys to dense positions
+ * is paged: a page of SPARSE_SET_PAGE_SIZE keys is only allocated once one of
+ * its keys is added, so memory is proportional to the members, not to the key
+ * range. Keys are below SPARSE_SET_MAX_KEYS, which covers every EntityIdx.
+ * Removing swaps the last value into the hole, so values move and pointers to
+ * them are invalidated by `sparse_set_add()` and `sparse_set_remove()`.
+ *
+ * Every generated set starts with a `SparseSetIndex`, sets of different types
+ * are joined through it with `SparseSetJoin`.
+ *
+ * This library is not thread safe.
+ *
+ * Configuration options:
+ *
+ * - SPARSE_SET_REALLOC (default realloc(3)): specify the allocator. If using a
+ *   custom allocator, must also specify SPARSE_SET_FREE.
+ *
+ * - SPARSE_SET_FREE (default free(3)): specify the deallocator. If using a
+ *   custom deallocator, must also specify SPARSE_SET_REALLOC.
+ *
+ *
+ * API Functions:
+ *
+ * The following documentation takes this generated set for instance:
+ * SPARSE_SET_DECLARE(Set, sparse_set, SampleType)
+ *
+ * void sparse_set_init(Set *set)
+ *   Initialize an empty set. Optional if the set's memory is zero-ed out.
+ *
+ * void sparse_set_free(Set *set)
+ *   Deallocate the set's memory.
+ *
+ * SampleType *sparse_set_add(Set *set, uint32_t key)
+ *   Return the value of `key`, adding a zero-ed one if the key is not a
+ *   member. O(1) amortized complexity.
+ *
+ * bool sparse_set_remove(Set *set, uint32_t key)
+ *   Remove the key, return false if it was not a member. O(1) complexity.
+ *
+ * bool sparse_set_has(const Set *set, uint32_t key)
+ *   Return whether the key is a member. O(1) complexity.
+ *
+ * SampleType *sparse_set_get(const Set *set, uint32_t key)
+ *   Return the key's value, or NULL if it is not a member. O(1) complexity.
+ *
+ * Members are `set->index.keys[i]` and `set->values[i]` for i in
+ * [0, set->index.size).
+ *
+ *
+ * Joins:
+ *
+ * void sparse_set_join_init(SparseSetJoin *join,
+ *                           const SparseSetIndex *const sets[], uint32_t count)
+ *   Prepare iterating over the keys that are members of all `count` sets, at
+ *   most SPARSE_SET_JOIN_MAX. The smallest set drives the iteration, so it
+ *   costs O(smallest set * count).
+ *
+ * bool sparse_set_join_next(SparseSetJoin *join)
+ *   Move to the next key, return false once every key has been visited. The
+ *   key is `join->key`, its dense position in `sets[i]` is
+ *   `join->positions[i]`. Removing the current key from the sets is allowed,
+ *   adding keys or removing others is not.
+ *
+ *
+ * Example:
+ *  SPARSE_SET_DECLARE(Inventories, inventories, struct Inventory)
+ *  SPARSE_SET_DECLARE(Dialogues, dialogues, struct Dialogue)
+ *  ...
+ *  SparseSetJoin join;
+ *  sparse_set_join_init(&join, (const SparseSetIndex *[]) {
+ *	&inv.index, &talk.index }, 2);
+ *  while (sparse_set_join_next(&join)) {
+ *	struct Inventory *inventory = &inv.values[join.positions[0]];
+ *	struct Dialogue *dialogue = &talk.values[join.positions[1]];
+ *	...
+ *  }
+ */
+
+#if defined(SPARSE_SET_REALLOC) && !defined(SPARSE_SET_FREE) || \
+	!defined(SPARSE_SET_REALLOC) && defined(SPARSE_SET_FREE)
+#error "You must define both SPARSE_SET_REALLOC and SPARSE_SET_FREE, or neither."
+#endif
+#if !defined(SPARSE_SET_REALLOC) && !defined(SPARSE_SET_FREE)
+#define SPARSE_SET_REALLOC(p, s) (realloc((p), (s)))
+#define SPARSE_SET_FREE(p) (free((p)))
+#endif
+
+enum {
+	SPARSE_SET_PAGE_SIZE = 256,
+	SPARSE_SET_MAX_KEYS = 1 << 16,
+	SPARSE_SET_PAGE_COUNT = SPARSE_SET_MAX_KEYS / SPARSE_SET_PAGE_SIZE,
+	SPARSE_SET_JOIN_MAX = 8,
+};
+
+typedef struct SparseSetIndex {
+	/* Key of each dense position */
+	uint32_t *keys;
+	/* Dense position + 1 of each key, 0 when the key is not a member */
+	uint32_t *pages[SPARSE_SET_PAGE_COUNT];
+	uint32_t size;
+	uint32_t capacity;
+} SparseSetIndex;
+
+typedef struct SparseSetJoin {
+	const SparseSetIndex *sets[SPARSE_SET_JOIN_MAX];
+	uint32_t count;
+	/* Set driving the iteration, walked from its end */
+	uint32_t driver;
+	uint32_t cursor;
+	uint32_t key;
+	uint32_t positions[SPARSE_SET_JOIN_MAX];
+} SparseSetJoin;
+
+static inline void *sparse_set_realloc_try(void *ptr, size_t size)
+{
+	void *result = SPARSE_SET_REALLOC(ptr, size);
+
+	if (result == NULL) {
+		(void)fprintf(stderr, "Out of memory. Panic.\n");
+		abort();
+	}
+
+	return result;
+}
+
+/* Dense position + 1 of `key`, 0 if it is not a member */
+static inline uint32_t sparse_set_index_find(const SparseSetIndex *index,
+					     uint32_t key)
+{
+	assert(index != NULL);
+	assert(key < SPARSE_SET_MAX_KEYS);
+
+	const uint32_t *page = index->pages[key / SPARSE_SET_PAGE_SIZE];
+	if (page == NULL) {
+		return 0;
+	}
+
+	return page[key % SPARSE_SET_PAGE_SIZE];
+}
+
+static inline uint32_t *sparse_set_index_slot(SparseSetIndex *index,
+					      uint32_t key)
+{
+	uint32_t **page = &index->pages[key / SPARSE_SET_PAGE_SIZE];
+
+	if (*page == NULL) {
+		*page = sparse_set_realloc_try(NULL,
+			SPARSE_SET_PAGE_SIZE * sizeof(uint32_t));
+		memset(*page, 0, SPARSE_SET_PAGE_SIZE * sizeof(uint32_t));
+	}
+
+	return &(*page)[key % SPARSE_SET_PAGE_SIZE];
+}
+
+static inline void sparse_set_join_init(SparseSetJoin *join,
+					const SparseSetIndex *const sets[],
+					uint32_t count)
+{
+	assert(join != NULL);
+	assert(sets != NULL);
+	assert(count > 0 && count <= SPARSE_SET_JOIN_MAX);
+
+	memset(join, 0, sizeof(SparseSetJoin));
+	join->count = count;
+
+	for (uint32_t i = 0; i < count; i++) {
+		join->sets[i] = sets[i];
+		if (sets[i]->size < sets[join->driver]->size) {
+			join->driver = i;
+		}
+	}
+
+	join->cursor = sets[join->driver]->size;
+}
+
+static inline bool sparse_set_join_next(SparseSetJoin *join)
+{
+	assert(join != NULL);
+
+	const SparseSetIndex *driver = join->sets[join->driver];
+
+	/* Backwards, so removing the current key only moves visited keys */
+	while (join->cursor > 0) {
+		join->cursor--;
+		if (join->cursor >= driver->size) {
+			continue;
+		}
+
+		uint32_t key = driver->keys[join->cursor];
+		bool found = true;
+
+		for (uint32_t i = 0; i < join->count && found; i++) {
+			uint32_t position = sparse_set_index_find(join->sets[i], key);
+			found = position != 0;
+			join->positions[i] = position - 1;
+		}
+
+		if (found) {
+			join->key = key;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#define SPARSE_SET_DECLARE(Struct_Name_, Functions_Prefix_, Custom_Type_)\
+\
+typedef struct Struct_Name_ {\
+	/* First, so the set can be joined through it */\
+	SparseSetIndex index;\
+	Custom_Type_ *values;\
+} Struct_Name_;\
+\
+void Functions_Prefix_##_init(Struct_Name_ *set);\
+void Functions_Prefix_##_free(Struct_Name_ *set);\
+Custom_Type_ *Functions_Prefix_##_add(Struct_Name_ *set, uint32_t key);\
+bool Functions_Prefix_##_remove(Struct_Name_ *set, uint32_t key);\
+bool Functions_Prefix_##_has(const Struct_Name_ *set, uint32_t key);\
+Custom_Type_ *Functions_Prefix_##_get(const Struct_Name_ *set, uint32_t key);
+
+#define SPARSE_SET_DEFINE(Struct_Name_, Functions_Prefix_, Custom_Type_)\
+\
+void Functions_Prefix_##_init(Struct_Name_ *set)\
+{\
+	assert(set != NULL);\
+\
+	memset(set, 0, sizeof(Struct_Name_));\
+}\
+\
+void Functions_Prefix_##_free(Struct_Name_ *set)\
+{\
+	assert(set != NULL);\
+\
+	for (uint32_t i = 0; i < SPARSE_SET_PAGE_COUNT; i++) {\
+		SPARSE_SET_FREE(set->index.pages[i]);\
+	}\
+	SPARSE_SET_FREE(set->index.keys);\
+	SPARSE_SET_FREE(set->values);\
+\
+	Functions_Prefix_##_init(set);\
+}\
+\
+Custom_Type_ *Functions_Prefix_##_add(Struct_Name_ *set, uint32_t key)\
+{\
+	assert(set != NULL);\
+	assert(key < SPARSE_SET_MAX_KEYS);\
+\
+	uint32_t *slot = sparse_set_index_slot(&set->index, key);\
+	if (*slot != 0) {\
+		return &set->values[*slot - 1];\
+	}\
+\
+	if (set->index.size == set->index.capacity) {\
+		uint32_t capacity = set->index.capacity ? set->index.capacity * 2 : 16;\
+		set->index.keys = sparse_set_realloc_try(set->index.keys,\
+			capacity * sizeof(uint32_t));\
+		set->values = sparse_set_realloc_try(set->values,\
+			capacity * sizeof(Custom_Type_));\
+		set->index.capacity = capacity;\
+	}\
+\
+	uint32_t position = set->index.size++;\
+	set->index.keys[position] = key;\
+	memset(&set->values[position], 0, sizeof(Custom_Type_));\
+	*slot = position + 1;\
+\
+	return &set->values[position];\
+}\
+\
+bool Functions_Prefix_##_remove(Struct_Name_ *set, uint32_t key)\
+{\
+	assert(set != NULL);\
+\
+	uint32_t found = sparse_set_index_find(&set->index, key);\
+	if (found == 0) {\
+		return false;\
+	}\
+\
+	uint32_t hole = found - 1;\
+	uint32_t last = set->index.size - 1;\
+	uint32_t lastKey = set->index.keys[last];\
+\
+	set->index.keys[hole] = lastKey;\
+	set->values[hole] = set->values[last];\
+	*sparse_set_index_slot(&set->index, lastKey) = hole + 1;\
+	*sparse_set_index_slot(&set->index, key) = 0;\
+	set->index.size--;\
+\
+	return true;\
+}\
+\
+bool Functions_Prefix_##_has(const Struct_Name_ *set, uint32_t key)\
+{\
+	assert(set != NULL);\
+\
+	return sparse_set_index_find(&set->index, key) != 0;\
+}\
+\
+Custom_Type_ *Functions_Prefix_##_get(const Struct_Name_ *set, uint32_t key)\
+{\
+	assert(set != NULL);\
+\
+	uint32_t found = sparse_set_index_find(&set->index, key);\
+	if (found == 0) {\
+		return NULL;\
+	}\
+\
+	return &set->values[found - 1];\
+}
+
+/****************************************************************************
+ * Copyright (C) 2026 by Roland Marchand <roland.marchand@protonmail.com>   *
+ *                                                                          *
+ * Permission to use, copy, modify, and/or distribute this software for any *
+ * purpose with or without fee is hereby granted.                           *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED “AS IS” AND THE AUTHOR DISCLAIMS ALL WARRANTIES *
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF         *
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR  *
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES   *
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN    *
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF  *
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.           *
+ ****************************************************************************/
+
+#endif /* SPARSE_SET_H */
@@ -0,0 +1,148 @@
+#pragma once
+
+/* C11 threads. Apple's C library has no <threads.h>, so on POSIX systems the
+ * part of it the game uses is implemented on pthreads instead, under the
+ * same names. Elsewhere, Windows included, the C library provides it. */
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef pthread_t thrd_t;
+typedef pthread_mutex_t mtx_t;
+typedef pthread_cond_t cnd_t;
+typedef int (*thrd_start_t)(void *);
+
+enum {
+	thrd_success = 0,
+	thrd_nomem,
+	thrd_timedout,
+	thrd_busy,
+	thrd_error,
+};
+
+enum {
+	mtx_plain = 0,
+};
+
+/* What the thread runs, freed by the thread once it started */
+struct ThreadStart {
+	thrd_start_t run;
+	void *arg;
+};
+
+static inline void *threadMain(void *data)
+{
+	struct ThreadStart start = *(struct ThreadStart *)data;
+	free(data);
+
+	return (void *)(intptr_t)start.run(start.arg);
+}
+
+static inline int thrd_create(thrd_t *thread, thrd_start_t run, void *arg)
+{
+	struct ThreadStart *start = malloc(sizeof(*start));
+	if (start == NULL) {
+		return thrd_nomem;
+	}
+	start->run = run;
+	start->arg = arg;
+
+	if (pthread_create(thread, NULL, threadMain, start) != 0) {
+		free(start);
+		return thrd_error;
+	}
+
+	return thrd_success;
+}
+
+static inline int thrd_join(thrd_t thread, int *result)
+{
+	void *value = NULL;
+	if (pthread_join(thread, &value) != 0) {
+		return thrd_error;
+	}
+	if (result != NULL) {
+		*result = (int)(intptr_t)value;
+	}
+
+	return thrd_success;
+}
+
+static inline thrd_t thrd_current(void)
+{
+	return pthread_self();
+}
+
+static inline int thrd_equal(thrd_t a, thrd_t b)
+{
+	return pthread_equal(a, b);
+}
+
+/* 0 once slept, -1 if interrupted, with the time left in `remaining` */
+static inline int thrd_sleep(
+	const struct timespec *duration,
+	struct timespec *remaining
+)
+{
+	if (nanosleep(duration, remaining) == 0) {
+		return 0;
+	}
+
+	return errno == EINTR ? -1 : -2;
+}
+
+static inline int mtx_init(mtx_t *mutex, int type)
+{
+	(void)type;
+
+	return pthread_mutex_init(mutex, NULL) == 0 ? thrd_success : thrd_error;
+}
+
+static inline int mtx_lock(mtx_t *mutex)
+{
+	return pthread_mutex_lock(mutex) == 0 ? thrd_success : thrd_error;
+}
+
+static inline int mtx_unlock(mtx_t *mutex)
+{
+	return pthread_mutex_unlock(mutex) == 0 ? thrd_success : thrd_error;
+}
+
+static inline void mtx_destroy(mtx_t *mutex)
+{
+	pthread_mutex_destroy(mutex);
+}
+
+static inline int cnd_init(cnd_t *condition)
+{
+	return pthread_cond_init(condition, NULL) == 0
+		? thrd_success : thrd_error;
+}
+
+static inline int cnd_wait(cnd_t *condition, mtx_t *mutex)
+{
+	return pthread_cond_wait(condition, mutex) == 0
+		? thrd_success : thrd_error;
+}
+
+static inline int cnd_broadcast(cnd_t *condition)
+{
+	return pthread_cond_broadcast(condition) == 0
+		? thrd_success : thrd_error;
+}
+
+static inline void cnd_destroy(cnd_t *condition)
+{
+	pthread_cond_destroy(condition);
+}
+
+#else
+
+#include <threads.h>
+
+#endif
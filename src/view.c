@@ -1,10 +1,17 @@
 #include "view.h"
 
 #include "list/list.h"
+#include "memstats.h"
+#include "message_log.h"
+#include "profiler.h"
+#include "simulation.h"
+#include "virtual_list.h"
 
 #define CLAY_IMPLEMENTATION
 #include "clay/clay.h"
+#include "clay/clay_renderer_raylib.c"
 #include "clay/layout.c"
+#include "clay/clay_frame.c"
 
 #define CLAY_CSTRING(str) (Clay_String) { .length = strlen(str), .chars = str }
 #define RAYLIB_VECTOR2_TO_CLAY_VECTOR2(vector)\
@@ -26,45 +33,82 @@ typedef struct ScrollBarData {
     bool mouseDown;
 } ScrollbarData;
 
-static u32 clayMemorySize;
-static Clay_Arena clayMemory;
-static bool mustReinitializeClay;
 static Font fonts[FONT_ID_MAX];
 static Texture2D textures[TEXTURE_MAX];
 static bool debugEnabled;
 static ScrollbarData scrollbarData;
-static ListString *messages;
+static struct MessageLog messageLog;
 static ListString *actions;
+/* Heights of the messages. Only the messages near the visible part of
+ * MainContent become elements, and only those are measured again when the
+ * width they wrap in changes: the others keep their last height until the
+ * view comes near them. */
+static struct VirtualList messageRows;
+/* Width each message was last measured at */
+static ListFloat messageRowWidths;
+/* The layout holds the text of messages read back from the history, copied to
+ * frame memory since reading more pages can evict theirs */
+static bool messagesInFrameMemory;
+/* Action clicked during the layout, applied before the next frame's layout:
+ * pushing a message may overwrite the text of older ones in the log, which
+ * the frame's render commands point to */
+static bool actionClicked;
+static size_t clickedAction;
+/* Something changed after the frame's layout, the next frame must not wait */
+static bool redrawPending;
+static bool eventWaiting;
+
+/* Everything the layout reads besides Clay's own state. Compared byte-wise,
+ * so it is zeroed before filling to keep the padding equal. */
+struct LayoutKey {
+	u32 messagesVersion;
+	u32 actionsVersion;
+	Clay_Dimensions dimensions;
+	Clay_Vector2 mousePosition;
+	Clay_Vector2 scrollPosition;
+	bool mouseDown;
+	bool cursorOnScreen;
+	bool scrollbarDown;
+};
 
-static void HandleClayErrors(Clay_ErrorData errorData) {
-	errorf("%s", errorData.errorText.chars);
-	if (errorData.errorType == CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED) {
-		mustReinitializeClay = true;
-		Clay_SetMaxElementCount(Clay_GetMaxElementCount() * 2);
-	} else if (errorData.errorType == CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED) {
-		mustReinitializeClay = true;
-		Clay_SetMaxMeasureTextCacheWordCount(Clay_GetMaxMeasureTextCacheWordCount() * 2);
-	}
+/* Bumped whenever the list changes, invalidates the cached layout */
+static u32 messagesVersion;
+static u32 actionsVersion;
+static struct LayoutKey cachedKey;
+static Clay_RenderCommandArray cachedCommands;
+static bool layoutCached;
+/* See viewIdleNanoseconds() */
+static u64 idleNanoseconds;
+
+/* From GLFW, built into raylib on desktop: wakes a thread blocked waiting
+ * for events, from any thread */
+void glfwPostEmptyEvent(void);
+
+static void wakeView(void)
+{
+	glfwPostEmptyEvent();
 }
 
-static Error initViewClay(void)
+static Clay_Dimensions getLayoutDimensions(void)
+{
+	return (Clay_Dimensions) {
+		(float)GetScreenWidth(),
+		(float)GetScreenHeight()
+	};
+}
+
+/* Settings that live in Clay's context, lost when the context is replaced */
+static void configureClay(void)
 {
-	clayMemorySize = Clay_MinMemorySize();
-	clayMemory = Clay_CreateArenaWithCapacityAndMemory(
-		clayMemorySize,
-		malloc_try(clayMemorySize));
+	Clay_SetMeasureTextFunction(Raylib_MeasureText, fonts);
+	Clay_SetDebugModeEnabled(debugEnabled);
+}
 
-	Clay_Context *ctx = Clay_Initialize(
-		clayMemory,
-		(Clay_Dimensions) {
-			(float)GetScreenWidth(),
-			(float)GetScreenHeight()
-		},
-		(Clay_ErrorHandler) { HandleClayErrors, 0 });
-	if (ctx == NULL) {
-		/* TODO: verify proper memory management,
-		 * but crash and burn for now */
-		return ERR_OUT_OF_MEMORY;
+static Error initViewClay(void)
+{
+	Error err = initLayout();
+	if (err != ERR_OK) {
+		return err;
 	}
 
 	Clay_Raylib_Initialize(
@@ -93,8 +137,6 @@ static Error initFonts(void)
 		SetTextureFilter(fonts[i].texture, TEXTURE_FILTER_BILINEAR);
 	}
 
-	Clay_SetMeasureTextFunction(Raylib_MeasureText, fonts);
-
 	return ERR_OK;
 }
 
@@ -117,26 +159,46 @@ static Error initTextures(void)
 	return ERR_OK;
 }
 
-Error initView(void)
+static Error initMessages(void)
 {
-	messages = (ListString*)newList();
-	list_string_push(messages, "lmao0");
-	list_string_push(messages, "lmao1");
-	list_string_push(messages, "lmao2");
-	list_string_push(messages, "lmao3");
-	list_string_push(messages, "lmao4");
-	list_string_push(messages, "lmao5");
-	list_string_push(messages, "lmao6");
-	list_string_push(messages, "lmao7");
-	list_string_push(messages, "lmao8");
-	list_string_push(messages, "lmao9");
+	const char *placeholders[] = {
+		"lmao0", "lmao1", "lmao2", "lmao3", "lmao4",
+		"lmao5", "lmao6", "lmao7", "lmao8", "lmao9",
+	};
+
+	/* The game goes on without a history, keeping only the latest
+	 * messages */
+	Error err = messageLogInit(&messageLog, MESSAGE_LOG_FILE);
+	if (err != ERR_OK) {
+		errorf("Could not create %s, older messages will be lost: %s\n",
+		       MESSAGE_LOG_FILE, errorToString(err));
+	}
 
+	for (size_t i = 0; i < ARRAY_LENGTH(placeholders); i++) {
+		err = messageLogPush(&messageLog, placeholders[i]);
+		if (err != ERR_OK) {
+			errorf("Could not write %s, older messages will be "
+			       "lost: %s\n", MESSAGE_LOG_FILE,
+			       errorToString(err));
+		}
+	}
+
+	return ERR_OK;
+}
+
+Error initView(void)
+{
 	actions = (ListString*)newList();
 	list_string_push(actions, "Eat");
 	list_string_push(actions, "Slap");
 	list_string_push(actions, "Sleep");
+	actionsVersion++;
+
+	virtualListInit(&messageRows, getMainContentLayout().childGap);
+	list_float_init(&messageRowWidths, VECTOR_DEFAULT_CAPACITY);
 
 	Step steps[] = {
+		initMessages,
 		initViewClay,
 		initFonts,
 		initTextures,
@@ -149,23 +211,9 @@ Error initView(void)
 		}
 	}
 
-	return ERR_OK;
-}
+	simulationSetViewWake(wakeView);
 
-static void reinitializeClay(void)
-{
-	Clay_SetMaxElementCount(8192);
-	clayMemorySize = Clay_MinMemorySize();
-	clayMemory = Clay_CreateArenaWithCapacityAndMemory(
-		clayMemorySize, malloc_try(clayMemorySize));
-	Clay_Initialize(
-		clayMemory,
-		(Clay_Dimensions) {
-			(float)GetScreenWidth(),
-			(float)GetScreenHeight()
-		},
-		(Clay_ErrorHandler) { HandleClayErrors, 0 });
-	mustReinitializeClay = false;
+	return ERR_OK;
 }
 
 static void updateAndGetMouseData(
@@ -184,10 +232,7 @@ static void updateAndGetMouseData(
 	Clay_SetPointerState(
 		*mousePosition,
 		IsMouseButtonDown(0) && !scrollbarData.mouseDown);
-	Clay_SetLayoutDimensions((Clay_Dimensions) {
-		(float)GetScreenWidth(),
-		(float)GetScreenHeight()
-	});
+	Clay_SetLayoutDimensions(getLayoutDimensions());
 
 	/* Mouse button */
 	if (!IsMouseButtonDown(0)) {
@@ -195,11 +240,32 @@ static void updateAndGetMouseData(
 	}
 }
 
+/* Height of every message, the rows that were not laid out included */
+static float getMessagesContentHeight(void)
+{
+	Clay_Padding padding = getMainContentLayout().padding;
+
+	return padding.top + virtualListHeight(&messageRows) + padding.bottom;
+}
+
+/* MainContent's scroll data with the height of every message, the height
+ * Clay measured lags a frame behind new messages */
+static Clay_ScrollContainerData getMainContentScrollData(void)
+{
+	Clay_ScrollContainerData scrollData = Clay_GetScrollContainerData(
+		Clay_GetElementId(CLAY_STRING("MainContent")));
+
+	if (scrollData.found) {
+		scrollData.contentDimensions.height = getMessagesContentHeight();
+	}
+
+	return scrollData;
+}
+
 static void updateScrollContainers(Clay_Vector2 mousePosition)
 {
 	Clay_ScrollContainerData scrollContainerData
-		= Clay_GetScrollContainerData(
-			Clay_GetElementId(CLAY_STRING("MainContent")));
+		= getMainContentScrollData();
 
 	if (IsMouseButtonDown(0)
 	    && !scrollbarData.mouseDown
@@ -243,28 +309,301 @@ static void updateScrollContainers(Clay_Vector2 mousePosition)
 	}
 }
 
-static void createScrollBar(void)
+/* Height of the text once Clay wrapped it in `width`, the way
+ * Clay__CalculateFinalLayout() breaks lines: after words and their trailing
+ * space, and at newlines */
+static float measureMessageHeight(Clay_String text, float width)
+{
+	Clay_TextElementConfig config = getFontBody();
+	Clay_StringSlice whole = {
+		.length = text.length,
+		.chars = text.chars,
+		.baseChars = text.chars
+	};
+	Clay_Dimensions unwrapped = Raylib_MeasureText(whole, &config, fonts);
+	bool newlines = memchr(text.chars, '\n', text.length) != NULL;
+
+	if (!newlines && unwrapped.width <= width) {
+		return unwrapped.height;
+	}
+
+	Clay_StringSlice space = { .length = 1, .chars = " ", .baseChars = " " };
+	float spaceWidth = Raylib_MeasureText(space, &config, fonts).width;
+	float lineWidth = 0.0f;
+	u32 lines = 1;
+	i32 start = 0;
+
+	for (i32 end = 0; end <= text.length; end++) {
+		char current = end < text.length ? text.chars[end] : '\0';
+		if (current != ' ' && current != '\n' && current != '\0') {
+			continue;
+		}
+
+		float wordWidth = current == ' ' ? spaceWidth : 0.0f;
+		if (end > start) {
+			Clay_StringSlice word = {
+				.length = end - start,
+				.chars = text.chars + start,
+				.baseChars = text.chars
+			};
+			wordWidth += Raylib_MeasureText(word, &config, fonts).width;
+		}
+
+		if (lineWidth > 0.0f && lineWidth + wordWidth > width) {
+			lines++;
+			lineWidth = 0.0f;
+		}
+		lineWidth += wordWidth;
+
+		if (current == '\n') {
+			lines++;
+			lineWidth = 0.0f;
+		}
+		start = end + 1;
+	}
+
+	return (float)lines * unwrapped.height;
+}
+
+/* Text of message `index`, the log only loses it if its history failed */
+static Clay_String getMessage(u64 index)
+{
+	const char *text = messageLogGet(&messageLog, index);
+
+	return CLAY_CSTRING(text != NULL ? text : "...");
+}
+
+/* Text of message `index` for the layout's elements */
+static Clay_String getLaidOutMessage(u64 index)
+{
+	if (!messageLogIsPaged(&messageLog, index)) {
+		return getMessage(index);
+	}
+
+	const char *text = messageLogGet(&messageLog, index);
+	char *copy = frameDuplicateString(text != NULL ? text : "...");
+	messagesInFrameMemory = true;
+
+	return CLAY_CSTRING(copy);
+}
+
+/* Measure the messages added since the last frame */
+static void syncMessageRows(float width)
+{
+	for (u64 i = virtualListCount(&messageRows);
+	     i < messageLogCount(&messageLog); i++) {
+		virtualListPush(&messageRows,
+				measureMessageHeight(getMessage(i), width));
+		list_float_push(&messageRowWidths, width);
+	}
+}
+
+/* Measure the rows of `range` last measured at another width again, returns
+ * whether there were any. `*top` follows the row it is in, so the rows
+ * changing above it don't move what is seen. */
+static bool remeasureMessageRows(
+	struct VirtualRange range,
+	float width,
+	float *top
+)
+{
+	size_t first = range.first;
+	while (first < range.end && messageRowWidths.begin[first] == width) {
+		first++;
+	}
+	if (first == range.end) {
+		return false;
+	}
+
+	size_t anchor = virtualListRange(&messageRows, *top, 0.0f, 0.0f).first;
+	bool anchored = anchor < virtualListCount(&messageRows);
+	float offset = anchored
+		? *top - virtualListTop(&messageRows, anchor) : 0.0f;
+
+	float *heights = frameAlloc((range.end - first) * sizeof(float));
+	for (size_t i = first; i < range.end; i++) {
+		if (messageRowWidths.begin[i] == width) {
+			heights[i - first] = virtualListRowHeight(&messageRows, i);
+			continue;
+		}
+		heights[i - first] = measureMessageHeight(getMessage(i), width);
+		messageRowWidths.begin[i] = width;
+	}
+	virtualListResize(&messageRows, first, heights, range.end - first);
+
+	if (anchored) {
+		*top = virtualListTop(&messageRows, anchor) + offset;
+	}
+
+	return true;
+}
+
+/* Stands in for the rows of a list that are too far to be seen */
+static Clay_ElementDeclaration getSpacer(float height)
 {
+	return (Clay_ElementDeclaration) {
+		.layout = {
+			.sizing = {
+				.width = CLAY_SIZING_FIXED(0),
+				.height = CLAY_SIZING_FIXED(height)
+			}
+		}
+	};
+}
+
+/* Only the messages within a screen of MainContent's visible part become
+ * elements, spacers keep the height of the others */
+static void createMessages(void)
+{
+	Clay_LayoutConfig layout = getMainContentLayout();
 	Clay_ScrollContainerData scrollData = Clay_GetScrollContainerData(
 		Clay_GetElementId(CLAY_STRING("MainContent")));
 
-	if (!scrollData.found) {
-		return;
+	/* Until MainContent was laid out once, assume it fills the screen */
+	Clay_Dimensions visible = getLayoutDimensions();
+	float top = 0.0f;
+	if (scrollData.found) {
+		visible = scrollData.scrollContainerDimensions;
+		top = -scrollData.scrollPosition->y - layout.padding.top;
 	}
 
-	Clay_ElementDeclaration scrollBar
-		= getScrollBar(CLAY_STRING("MainContent"), scrollData);
-	Clay_ElementDeclaration scrollBarButton
-		= getScrollBarButton(CLAY_STRING("ScrollBar"), scrollData);
+	float width = visible.width - layout.padding.left
+		- layout.padding.right;
+	syncMessageRows(width);
+
+	/* Rows measured again can bring others into the range */
+	float measuredTop = top;
+	struct VirtualRange range;
+	do {
+		range = virtualListRange(&messageRows, measuredTop,
+					 visible.height, visible.height);
+	} while (remeasureMessageRows(range, width, &measuredTop));
+	if (scrollData.found && measuredTop != top) {
+		scrollData.scrollPosition->y
+			= -(measuredTop + layout.padding.top);
+	}
 
-	CLAY(CLAY_ID("ScrollBar"), scrollBar) {
-                CLAY(CLAY_ID("ScrollBarButton"), scrollBarButton) {}
+	messagesInFrameMemory = false;
+	if (range.first > 0) {
+		CLAY(CLAY_ID("MessagesBefore"), getSpacer(range.spaceBefore)) {}
+	}
+	for (size_t i = range.first; i < range.end; i++) {
+		CLAY_TEXT(getLaidOutMessage(i), getFontBody());
+	}
+	if (range.end < virtualListCount(&messageRows)) {
+		CLAY(CLAY_ID("MessagesAfter"), getSpacer(range.spaceAfter)) {}
+	}
+}
+
+static void createMemoryLine(const char *name, struct MemStats stats)
+{
+	char *line = frameSprintf(
+		"%-12s %9.1f KiB live %9.1f KiB peak %8llu allocs %5zu chunks",
+		name,
+		(double)stats.bytesLive / 1024.0,
+		(double)stats.bytesPeak / 1024.0,
+		(unsigned long long)stats.allocCount,
+		stats.chunkCount);
+
+	CLAY_TEXT(CLAY_CSTRING(line), getFontDebug());
+}
+
+static void createSimulationLine(void)
+{
+	const struct WorldSnapshot *snapshot = simulationSnapshot();
+	char *line = frameSprintf(
+		"tick %llu %9.1f s game time %6u entities %8llu deaths",
+		(unsigned long long)snapshot->tick,
+		snapshot->gameSeconds,
+		(unsigned)snapshot->entityCount,
+		(unsigned long long)snapshot->deathCount);
+
+	CLAY_TEXT(CLAY_CSTRING(line), getFontDebug());
+}
+
+static void createProfileLine(ProfileZone zone)
+{
+	struct ProfileStats stats = profilerStats(zone);
+	char *line = frameSprintf(
+		"%-12s %7.2f ms p50 %7.2f ms p99 %7.2f ms max",
+		profileZoneToString(zone),
+		(double)stats.p50 / 1e6,
+		(double)stats.p99 / 1e6,
+		(double)stats.max / 1e6);
+
+	CLAY_TEXT(CLAY_CSTRING(line), getFontDebug());
+}
+
+static void createDebugOverlay(void)
+{
+	CLAY(CLAY_ID("DebugOverlay"), getDebugOverlay()) {
+		createSimulationLine();
+		for (ProfileZone zone = 0; zone < PROFILE_ZONE_FRAME_MAX; zone++) {
+			createProfileLine(zone);
+		}
+		for (MemTag tag = 0; tag < MEM_TAG_MAX; tag++) {
+			createMemoryLine(memTagToString(tag), memStatsGet(tag));
+		}
+		createMemoryLine("total", memStatsTotal());
 	}
 }
 
 static void clickAction(size_t index)
 {
-	list_string_push(messages, list_string_get(actions, index));
+	actionClicked = true;
+	clickedAction = index;
+	redrawPending = true;
+}
+
+static void applyClickedAction(void)
+{
+	if (!actionClicked) {
+		return;
+	}
+
+	Error err = messageLogPush(&messageLog,
+				   list_string_get(actions, clickedAction));
+	if (err != ERR_OK) {
+		errorf("Could not write %s, older messages will be lost: %s\n",
+		       MESSAGE_LOG_FILE, errorToString(err));
+	}
+	messagesVersion++;
+	actionClicked = false;
+}
+
+/* Whether the screen keeps changing without input: live overlay stats,
+ * scrollbar drags and scroll momentum */
+static bool isAnimating(void)
+{
+	if (debugEnabled || redrawPending || scrollbarData.mouseDown) {
+		return true;
+	}
+
+	Clay_Context *ctx = Clay_GetCurrentContext();
+	for (i32 i = 0; i < ctx->scrollContainerDatas.length; i++) {
+		Clay__ScrollContainerDataInternal *scroll =
+			&ctx->scrollContainerDatas.internalArray[i];
+		if (scroll->pointerScrollActive || scroll->scrollMomentum.x != 0
+		    || scroll->scrollMomentum.y != 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* When idle, EndDrawing() blocks until an event arrives: input, resizing,
+ * closing or a wake from the simulation */
+static void updateEventWaiting(void)
+{
+	bool idle = !isAnimating();
+
+	if (idle && !eventWaiting) {
+		EnableEventWaiting();
+	} else if (!idle && eventWaiting) {
+		DisableEventWaiting();
+	}
+	eventWaiting = idle;
 }
 
 static Clay_RenderCommandArray createLayout(void)
@@ -273,10 +612,7 @@ static Clay_RenderCommandArray createLayout(void)
 
 	CLAY(CLAY_ID("Body"), getBody()) {
 		CLAY(CLAY_ID("MainContent"), getMainContent()) {
-			for (char **str = messages->begin; str < messages->end; str++) {
-				char *string = *str;
-				CLAY_TEXT(CLAY_CSTRING(string), getFontBody());
-			}
+			createMessages();
 		}
 
 		CLAY(CLAY_ID("ActionSection"), getActionSection()) {
@@ -295,13 +631,98 @@ static Clay_RenderCommandArray createLayout(void)
 		}
 	}
 
-	createScrollBar();
+	createScrollBar(getMainContentScrollData());
 
-	return Clay_EndLayout(GetFrameTime());
+	if (debugEnabled) {
+		createDebugOverlay();
+	}
+
+	u64 start = profilerBegin();
+	Clay_RenderCommandArray renderCommands = Clay_EndLayout(GetFrameTime());
+	profilerEnd(PROFILE_ZONE_END_LAYOUT, start);
+
+	return renderCommands;
+}
+
+static struct LayoutKey getLayoutKey(Clay_Vector2 mousePosition)
+{
+	struct LayoutKey key;
+	memset(&key, 0, sizeof(key));
+
+	key.messagesVersion = messagesVersion;
+	key.actionsVersion = actionsVersion;
+	key.dimensions = getLayoutDimensions();
+	key.mousePosition = mousePosition;
+	key.mouseDown = IsMouseButtonDown(0);
+	key.cursorOnScreen = IsCursorOnScreen();
+	key.scrollbarDown = scrollbarData.mouseDown;
+
+	Clay_ScrollContainerData scrollData = Clay_GetScrollContainerData(
+		Clay_GetElementId(CLAY_STRING("MainContent")));
+	if (scrollData.found) {
+		key.scrollPosition = *scrollData.scrollPosition;
+	}
+
+	return key;
+}
+
+/* The previous frame's commands can be drawn again when nothing the layout
+ * depends on changed. Wheel input and momentum move the scroll containers,
+ * which only Clay_UpdateScrollContainers() applies, and the overlay shows
+ * live stats from frame memory. */
+static bool canReuseLayout(const struct LayoutKey *key, Clay_Vector2 wheel)
+{
+	if (!layoutCached || debugEnabled || isAnimating()) {
+		return false;
+	}
+	if (wheel.x != 0.0f || wheel.y != 0.0f) {
+		return false;
+	}
+
+	return memcmp(key, &cachedKey, sizeof(*key)) == 0;
+}
+
+static Clay_RenderCommandArray relayout(
+	Clay_Vector2 mousePosition,
+	Clay_Vector2 wheel
+)
+{
+	SetMouseCursor(MOUSE_CURSOR_DEFAULT);
+
+	updateScrollContainers(mousePosition);
+	Clay_UpdateScrollContainers(true, wheel, GetFrameTime());
+
+	Clay_RenderCommandArray renderCommands = layOut();
+
+	/* Keyed on the state after this frame's updates, so a frame with the
+	 * same input afterwards finds it. Text in frame memory, the overlay's
+	 * or old messages', doesn't outlive the next frame: never keep it. */
+	cachedKey = getLayoutKey(mousePosition);
+	cachedCommands = renderCommands;
+	layoutCached = !debugEnabled && !messagesInFrameMemory;
+
+	return renderCommands;
+}
+
+static void dumpTrace(void)
+{
+	Error err = profilerDumpTrace(PROFILER_TRACE_FILE);
+	if (err != ERR_OK) {
+		errorf("Could not write %s: %s\n", PROFILER_TRACE_FILE,
+		       errorToString(err));
+		return;
+	}
+
+	errorf("Wrote %s\n", PROFILER_TRACE_FILE);
 }
 
 static void updateDrawFrame(void)
 {
+	redrawPending = false;
+	/* Clicked during the last layout. Applied before the layout is keyed,
+	 * so a click always lays out again. */
+	applyClickedAction();
+
 	/* Mouse wheel */
 	float mouseWheelX = 0.0f;
 	float mouseWheelY = 0.0f;
@@ -314,41 +735,60 @@ static void updateDrawFrame(void)
 		debugEnabled = !debugEnabled;
 		Clay_SetDebugModeEnabled(debugEnabled);
 	}
+	if (IsKeyPressed(KEY_F4)) {
+		dumpTrace();
+	}
 
-	updateScrollContainers(mousePosition);
-	Clay_UpdateScrollContainers(
-		true,
-		(Clay_Vector2) {mouseWheelX, mouseWheelY}, GetFrameTime());
-
-	Clay_RenderCommandArray renderCommands = createLayout();
+	/* Skipping the layout also skips Clay_UpdateScrollContainers(), which
+	 * would drop the containers the skipped layout didn't open again */
+	Clay_Vector2 wheel = { mouseWheelX, mouseWheelY };
+	struct LayoutKey key = getLayoutKey(mousePosition);
+	Clay_RenderCommandArray renderCommands = canReuseLayout(&key, wheel)
+		? cachedCommands
+		: relayout(mousePosition, wheel);
+	updateEventWaiting();
 
 	/* Rendering */
-	BeginDrawing(); {
-		ClearBackground(BLACK);
-		Clay_Raylib_Render(renderCommands, fonts);
-	} EndDrawing();
+	BeginDrawing();
+	ClearBackground(BLACK);
+	u64 start = profilerBegin();
+	Clay_Raylib_Render(renderCommands, fonts);
+	profilerEnd(PROFILE_ZONE_RENDER, start);
+
+	/* EndDrawing() waits for events when idle, the buffer swap then counts
+	 * as idle along with the wait */
+	u64 waitStart = get_nanoseconds();
+	EndDrawing();
+	if (eventWaiting) {
+		idleNanoseconds = get_nanoseconds() - waitStart;
+	}
 }
 
 Error updateView(void)
 {
+	idleNanoseconds = 0;
+
 	if (WindowShouldClose()) {
 		exitGameLoop();
 		return ERR_OK;
 	}
 
-	if (mustReinitializeClay) {
-		reinitializeClay();
-        }
-
-	SetMouseCursor(MOUSE_CURSOR_DEFAULT);
-
         updateDrawFrame();
 
 	return ERR_OK;
 }
 
+u64 viewIdleNanoseconds(void)
+{
+	return idleNanoseconds;
+}
+
 Error cleanupView(void)
 {
+	virtualListCleanup(&messageRows);
+	list_float_free(&messageRowWidths);
+	messageLogCleanup(&messageLog);
+
 	/* Fonts */
 	for (size_t i = 0; i < ARRAY_LENGTH(fonts); i++) {
 		UnloadFont(fonts[i]);
@@ -360,6 +800,7 @@ Error cleanupView(void)
 	}
 
 	Clay_Raylib_Close();
+	cleanupClayMemory();
 
 	return ERR_OK;
 }
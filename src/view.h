@@ -4,4 +4,7 @@
 
 Error initView(void);
 Error updateView(void);
+/* Nanoseconds the last updateView() spent blocked, waiting for events or
+ * pacing frames, rather than working */
+u64 viewIdleNanoseconds(void);
 Error cleanupView(void);
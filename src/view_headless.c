@@ -0,0 +1,200 @@
+/* View of the headless build: no window and no raylib, for servers, soak
+ * tests and benchmarks. The game runs until GAME_TICKS simulation ticks have
+ * passed, or until interrupted. With GAME_LAYOUT set, every frame is still
+ * laid out by Clay, measuring text with a stub, so layout shows up in
+ * headless profiles. With GAME_TRACE set, the profiler's trace is written to
+ * that path on exit. */
+
+#include <signal.h>
+#include <stdlib.h>
+
+#include "view.h"
+
+#include "memstats.h"
+#include "profiler.h"
+#include "simulation.h"
+#include "thread.h"
+
+/* layout.c's hover feedback, there is no cursor */
+#define MOUSE_CURSOR_POINTING_HAND 0
+static bool IsCursorOnScreen(void) { return false; }
+static void SetMouseCursor(int cursor) { (void)cursor; }
+
+#define CLAY_IMPLEMENTATION
+#include "clay/clay.h"
+#include "clay/layout.c"
+#include "clay/clay_frame.c"
+
+#define CLAY_CSTRING(str) (Clay_String) { .length = strlen(str), .chars = str }
+
+#define HEADLESS_FRAME_RATE 60
+
+enum {
+	SCREEN_WIDTH = 800,
+	SCREEN_HEIGHT = 450,
+};
+
+static const char *actions[] = { "Wait", "Look", "Sleep" };
+
+static volatile sig_atomic_t interrupted;
+/* 0 runs until interrupted */
+static u64 tickLimit;
+static bool layoutEnabled;
+/* See viewIdleNanoseconds() */
+static u64 idleNanoseconds;
+
+static void handleSignal(int signalNumber)
+{
+	(void)signalNumber;
+	interrupted = 1;
+}
+
+/* Stand-in for font metrics: every byte half as wide as the font is tall */
+static Clay_Dimensions measureTextStub(
+	Clay_StringSlice text,
+	Clay_TextElementConfig *config,
+	void *userData
+)
+{
+	(void)userData;
+
+	return (Clay_Dimensions) {
+		(float)text.length * (float)config->fontSize * 0.5f,
+		(float)config->fontSize
+	};
+}
+
+static Clay_Dimensions getLayoutDimensions(void)
+{
+	return (Clay_Dimensions) { SCREEN_WIDTH, SCREEN_HEIGHT };
+}
+
+static void configureClay(void)
+{
+	Clay_SetMeasureTextFunction(measureTextStub, NULL);
+}
+
+Error initView(void)
+{
+	const char *ticks = getenv("GAME_TICKS");
+	if (ticks != NULL) {
+		tickLimit = strtoull(ticks, NULL, 10);
+	}
+	layoutEnabled = getenv("GAME_LAYOUT") != NULL;
+
+	signal(SIGINT, handleSignal);
+	signal(SIGTERM, handleSignal);
+
+	if (!layoutEnabled) {
+		return ERR_OK;
+	}
+
+	return initLayout();
+}
+
+static void createDebugOverlay(void)
+{
+	CLAY(CLAY_ID("DebugOverlay"), getDebugOverlay()) {
+		for (MemTag tag = 0; tag < MEM_TAG_MAX; tag++) {
+			struct MemStats stats = memStatsGet(tag);
+			char *line = frameSprintf("%-12s %9.1f KiB live",
+				memTagToString(tag),
+				(double)stats.bytesLive / 1024.0);
+			CLAY_TEXT(CLAY_CSTRING(line), getFontDebug());
+		}
+	}
+}
+
+static Clay_RenderCommandArray createLayout(void)
+{
+	const struct WorldSnapshot *snapshot = simulationSnapshot();
+
+	Clay_BeginLayout();
+
+	CLAY(CLAY_ID("Body"), getBody()) {
+		CLAY(CLAY_ID("MainContent"), getMainContent()) {
+			char *line = frameSprintf("Tick %llu, %.1f s of game time",
+				(unsigned long long)snapshot->tick,
+				snapshot->gameSeconds);
+			CLAY_TEXT(CLAY_CSTRING(line), getFontBody());
+
+			line = frameSprintf("%u entities, %llu deaths",
+				(unsigned)snapshot->entityCount,
+				(unsigned long long)snapshot->deathCount);
+			CLAY_TEXT(CLAY_CSTRING(line), getFontBody());
+		}
+
+		CLAY(CLAY_ID("ActionSection"), getActionSection()) {
+			for (size_t i = 0; i < ARRAY_LENGTH(actions); i++) {
+				CLAY(CLAY_IDI("Action", i), getActionButton(NULL)) {
+					CLAY_TEXT(getActionOrderString(i + 1), getFontAction());
+					CLAY_TEXT(CLAY_CSTRING(actions[i]), getFontBody());
+				}
+			}
+		}
+	}
+
+	createScrollBar(Clay_GetScrollContainerData(
+		Clay_GetElementId(CLAY_STRING("MainContent"))));
+	createDebugOverlay();
+
+	u64 start = profilerBegin();
+	Clay_RenderCommandArray renderCommands
+		= Clay_EndLayout(1.0f / HEADLESS_FRAME_RATE);
+	profilerEnd(PROFILE_ZONE_END_LAYOUT, start);
+
+	return renderCommands;
+}
+
+Error updateView(void)
+{
+	idleNanoseconds = 0;
+	const struct WorldSnapshot *snapshot = simulationSnapshot();
+
+	if (interrupted || (tickLimit != 0 && snapshot->tick >= tickLimit)) {
+		exitGameLoop();
+		return ERR_OK;
+	}
+
+	if (layoutEnabled) {
+		layOut();
+	}
+
+	u64 start = get_nanoseconds();
+	thrd_sleep(&(struct timespec) {
+		.tv_nsec = 1000000000 / HEADLESS_FRAME_RATE
+	}, NULL);
+	idleNanoseconds = get_nanoseconds() - start;
+
+	return ERR_OK;
+}
+
+u64 viewIdleNanoseconds(void)
+{
+	return idleNanoseconds;
+}
+
+Error cleanupView(void)
+{
+	const struct WorldSnapshot *snapshot = simulationSnapshot();
+	printf("%llu ticks, %.1f s of game time, %u entities, %llu deaths\n",
+	       (unsigned long long)snapshot->tick,
+	       snapshot->gameSeconds,
+	       (unsigned)snapshot->entityCount,
+	       (unsigned long long)snapshot->deathCount);
+
+	const char *tracePath = getenv("GAME_TRACE");
+	if (tracePath != NULL) {
+		Error err = profilerDumpTrace(tracePath);
+		if (err != ERR_OK) {
+			errorf("Could not write %s: %s\n", tracePath,
+			       errorToString(err));
+		}
+	}
+
+	if (layoutEnabled) {
+		cleanupClayMemory();
+	}
+
+	return ERR_OK;
+}
@@ -0,0 +1,151 @@
+#include "virtual_list.h"
+
+#include <assert.h>
+
+void virtualListInit(struct VirtualList *list, float gap)
+{
+	list_float_init(&list->tops, VECTOR_DEFAULT_CAPACITY);
+	list_float_push(&list->tops, 0.0f);
+	list->gap = gap;
+}
+
+void virtualListCleanup(struct VirtualList *list)
+{
+	list_float_free(&list->tops);
+}
+
+void virtualListClear(struct VirtualList *list, float gap)
+{
+	list_float_clear(&list->tops);
+	list_float_push(&list->tops, 0.0f);
+	list->gap = gap;
+}
+
+void virtualListPush(struct VirtualList *list, float height)
+{
+	assert(height >= 0.0f);
+
+	float top = list->tops.end[-1];
+	list_float_push(&list->tops, top + height + list->gap);
+}
+
+size_t virtualListCount(const struct VirtualList *list)
+{
+	return VECTOR_SIZE(&list->tops) - 1;
+}
+
+float virtualListTop(const struct VirtualList *list, size_t index)
+{
+	assert(index < virtualListCount(list));
+
+	return list->tops.begin[index];
+}
+
+float virtualListRowHeight(const struct VirtualList *list, size_t index)
+{
+	assert(index < virtualListCount(list));
+
+	return list->tops.begin[index + 1] - list->tops.begin[index] - list->gap;
+}
+
+void virtualListResize(
+	struct VirtualList *list,
+	size_t first,
+	const float *heights,
+	size_t count
+)
+{
+	assert(first + count <= virtualListCount(list));
+
+	float *tops = list->tops.begin;
+	float shift = 0.0f;
+
+	for (size_t i = first; i < first + count; i++) {
+		assert(heights[i - first] >= 0.0f);
+		float old = tops[i + 1];
+		tops[i + 1] = tops[i] + heights[i - first] + list->gap;
+		shift = tops[i + 1] - old;
+	}
+
+	if (shift == 0.0f) {
+		return;
+	}
+	for (size_t i = first + count + 1; i < (size_t)VECTOR_SIZE(&list->tops);
+	     i++) {
+		tops[i] += shift;
+	}
+}
+
+float virtualListHeight(const struct VirtualList *list)
+{
+	if (virtualListCount(list) == 0) {
+		return 0.0f;
+	}
+
+	return list->tops.end[-1] - list->gap;
+}
+
+/* Index of the first row ending after `y`, count if none does */
+static size_t findRowEndingAfter(const struct VirtualList *list, float y)
+{
+	size_t low = 0;
+	size_t high = virtualListCount(list);
+
+	/* Row i ends at tops[i + 1] - gap */
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (list->tops.begin[middle + 1] - list->gap > y) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+
+	return low;
+}
+
+/* Index of the first row starting after `y`, count if none does */
+static size_t findRowStartingAfter(const struct VirtualList *list, float y)
+{
+	size_t low = 0;
+	size_t high = virtualListCount(list);
+
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (list->tops.begin[middle] > y) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+
+	return low;
+}
+
+struct VirtualRange virtualListRange(
+	const struct VirtualList *list,
+	float top,
+	float height,
+	float margin
+)
+{
+	struct VirtualRange range = { 0 };
+	size_t count = virtualListCount(list);
+
+	range.first = findRowEndingAfter(list, top - margin);
+	range.end = findRowStartingAfter(list, top + height + margin);
+	if (range.end < range.first) {
+		range.end = range.first;
+	}
+
+	/* The spacer's own gap completes the space up to the first row */
+	if (range.first > 0) {
+		range.spaceBefore = list->tops.begin[range.first] - list->gap;
+	}
+	if (range.end < count) {
+		range.spaceAfter = virtualListHeight(list)
+			- list->tops.begin[range.end];
+	}
+
+	return range;
+}
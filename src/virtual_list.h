@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "list/list.h"
+
+/* Positions of the rows of a long vertical list, so only the rows near the
+ * visible window need to become layout elements. Rows are appended with
+ * their height, and the list keeps the cumulative offsets: finding the rows
+ * in a window is a binary search. */
+struct VirtualList {
+	/* tops[i] is where row i starts, tops[count] is the total height plus
+	 * one gap */
+	ListFloat tops;
+	/* Space between two rows */
+	float gap;
+};
+
+/* Rows [first, end), and the space to leave before and after them so the
+ * content keeps the height of the whole list */
+struct VirtualRange {
+	size_t first;
+	size_t end;
+	float spaceBefore;
+	float spaceAfter;
+};
+
+void virtualListInit(struct VirtualList *list, float gap);
+void virtualListCleanup(struct VirtualList *list);
+/* Forget every row */
+void virtualListClear(struct VirtualList *list, float gap);
+void virtualListPush(struct VirtualList *list, float height);
+size_t virtualListCount(const struct VirtualList *list);
+/* Where row `index` starts */
+float virtualListTop(const struct VirtualList *list, size_t index);
+float virtualListRowHeight(const struct VirtualList *list, size_t index);
+/* Give rows [first, first + count) new heights, moving the rows after them.
+ * Linear in the rows from `first` to the end, once for the whole run. */
+void virtualListResize(
+	struct VirtualList *list,
+	size_t first,
+	const float *heights,
+	size_t count
+);
+/* Height of the rows and the gaps between them */
+float virtualListHeight(const struct VirtualList *list);
+/* The rows overlapping [top - margin, top + height + margin]. The space
+ * before and after already accounts for the gaps next to the spacers. */
+struct VirtualRange virtualListRange(
+	const struct VirtualList *list,
+	float top,
+	float height,
+	float margin
+);
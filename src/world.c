@@ -0,0 +1,41 @@
+#include <assert.h>
+#include <string.h>
+
+#include "world.h"
+
+void worldInit(struct World *world)
+{
+	assert(world != NULL);
+
+	memset(world, 0, sizeof(struct World));
+	entityAllocatorInit(&world->allocator);
+	entityComponentsInit(&world->entities);
+	locationIndexInit(&world->locations);
+	graphInit(&world->rooms.layout);
+}
+
+EntityId worldSpawn(struct World *world, RoomIdx room)
+{
+	assert(world != NULL);
+
+	EntityId id = entitySpawn(&world->allocator, &world->entities);
+	if (id != ENTITY_ID_NONE) {
+		locationMove(&world->locations, &world->entities,
+			     ENTITY_ID_INDEX(id), room);
+	}
+
+	return id;
+}
+
+bool worldDespawn(struct World *world, EntityId id)
+{
+	assert(world != NULL);
+
+	if (!entityIsAlive(&world->allocator, id)) {
+		return false;
+	}
+
+	locationMove(&world->locations, &world->entities,
+		     ENTITY_ID_INDEX(id), 0);
+	return entityDespawn(&world->allocator, &world->entities, id);
+}
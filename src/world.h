@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common.h"
+#include "entity.h"
+#include "location.h"
+#include "room.h"
+
+/* The game state, read and written by the systems of scheduler.h */
+struct World {
+	struct EntityAllocator allocator;
+	struct EntityComponents entities;
+	struct LocationIndex locations;
+	struct Rooms rooms;
+	/* Entities that died during the current tick */
+	EntityIdx newlyDead[MAX_ENTITIES];
+	size_t newlyDeadCount;
+	/* Game time covered by the current tick */
+	float tickSeconds;
+};
+
+void worldInit(struct World *world);
+/* Spawn an entity in `room`, 0 for none. Spawning and despawning through the
+ * world keeps the entity columns and the location index in sync. Returns
+ * ENTITY_ID_NONE when every slot is in use. */
+EntityId worldSpawn(struct World *world, RoomIdx room);
+/* Take the entity out of its room, then `entityDespawn()` it. Returns whether
+ * it was alive. */
+bool worldDespawn(struct World *world, EntityId id);
@@ -0,0 +1,144 @@
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "effects.h"
+#include "unity/unity.h"
+
+#define ENTITY_COUNT (2 * ENTITY_CHUNK_SIZE)
+
+static struct EntityComponents components;
+static EntityIdx dead[ENTITY_COUNT];
+
+void setUp(void)
+{
+	initArena();
+	entityComponentsInit(&components);
+	entityComponentsReserve(&components, ENTITY_COUNT);
+}
+
+void tearDown(void)
+{
+	cleanupArena();
+}
+
+static void setEntity(EntityIdx e, float health, float max, float dot,
+		      float regen)
+{
+	ENTITY(&components, healths, e) = health;
+	ENTITY(&components, maxHealths, e) = max;
+	ENTITY(&components, damageOverTime, e) = dot;
+	ENTITY(&components, regeneration, e) = regen;
+}
+
+void testDamageOverTime(void)
+{
+	setEntity(5, 10.0f, 10.0f, 2.0f, 0.0f);
+
+	TEST_ASSERT_EQUAL_size_t(0, effectsTick(&components, 0.5f, dead));
+	TEST_ASSERT_EQUAL_FLOAT(9.0f, ENTITY(&components, healths, 5));
+}
+
+void testRegenerationStopsAtMax(void)
+{
+	setEntity(5, 9.5f, 10.0f, 0.0f, 4.0f);
+	/* Above its max from a buff, regeneration does not cut it */
+	setEntity(6, 12.0f, 10.0f, 0.0f, 4.0f);
+
+	effectsTick(&components, 1.0f, dead);
+
+	TEST_ASSERT_EQUAL_FLOAT(10.0f, ENTITY(&components, healths, 5));
+	TEST_ASSERT_EQUAL_FLOAT(12.0f, ENTITY(&components, healths, 6));
+}
+
+void testDeathsReportedOnce(void)
+{
+	setEntity(3, 1.0f, 10.0f, 4.0f, 0.0f);
+	setEntity(ENTITY_CHUNK_SIZE + 17, 0.5f, 10.0f, 4.0f, 1.0f);
+	setEntity(40, 20.0f, 20.0f, 4.0f, 0.0f);
+
+	size_t count = effectsTick(&components, 1.0f, dead);
+
+	TEST_ASSERT_EQUAL_size_t(2, count);
+	TEST_ASSERT_EQUAL_UINT16(3, dead[0]);
+	TEST_ASSERT_EQUAL_UINT16(ENTITY_CHUNK_SIZE + 17, dead[1]);
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, ENTITY(&components, healths, 3));
+	TEST_ASSERT_EQUAL_FLOAT(16.0f, ENTITY(&components, healths, 40));
+
+	/* Dead entities stay dead, even when regenerating */
+	TEST_ASSERT_EQUAL_size_t(0, effectsTick(&components, 1.0f, dead));
+	TEST_ASSERT_EQUAL_FLOAT(
+		0.0f, ENTITY(&components, healths, ENTITY_CHUNK_SIZE + 17));
+}
+
+void testDespawnedNeverDies(void)
+{
+	static struct EntityAllocator allocator;
+	entityAllocatorInit(&allocator);
+
+	EntityId id = entitySpawn(&allocator, &components);
+	EntityIdx e = ENTITY_ID_INDEX(id);
+	setEntity(e, 1.0f, 10.0f, 4.0f, 0.0f);
+	TEST_ASSERT_TRUE(entityDespawn(&allocator, &components, id));
+
+	TEST_ASSERT_EQUAL_size_t(0, effectsTick(&components, 1.0f, dead));
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, ENTITY(&components, healths, e));
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, ENTITY(&components, damageOverTime, e));
+}
+
+void testMatchesScalar(void)
+{
+	static float expected[ENTITY_COUNT];
+	static EntityIdx expectedDead[ENTITY_COUNT];
+	size_t expectedCount = 0;
+	u32 state = 77;
+	float seconds = 0.25f;
+
+	for (size_t e = 0; e < ENTITY_COUNT; e++) {
+		state = state * 1664525u + 1013904223u;
+		float health = (float)((state >> 8) % 40) - 5.0f;
+		float max = (float)((state >> 14) % 30);
+		float dot = (float)((state >> 20) % 16);
+		float regen = (float)((state >> 26) % 8);
+		setEntity((EntityIdx)e, health, max, dot, regen);
+
+		expected[e] = health;
+		if (health > 0.0f) {
+			float next = health + seconds * (regen - dot);
+			float cap = health > max ? health : max;
+			next = next < cap ? next : cap;
+			expected[e] = next > 0.0f ? next : 0.0f;
+			if (expected[e] <= 0.0f) {
+				expectedDead[expectedCount++] = (EntityIdx)e;
+			}
+		}
+	}
+
+	size_t count = effectsTick(&components, seconds, dead);
+
+	for (size_t e = 0; e < ENTITY_COUNT; e++) {
+		TEST_ASSERT_EQUAL_FLOAT(expected[e],
+					ENTITY(&components, healths, e));
+	}
+	TEST_ASSERT_EQUAL_size_t(expectedCount, count);
+	if (count > 0) {
+		TEST_ASSERT_EQUAL_UINT16_ARRAY(expectedDead, dead, count);
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Effects */
+	RUN_TEST(testDamageOverTime);
+	RUN_TEST(testRegenerationStopsAtMax);
+	RUN_TEST(testDeathsReportedOnce);
+	RUN_TEST(testDespawnedNeverDies);
+
+	/* Against a scalar loop */
+	RUN_TEST(testMatchesScalar);
+
+	return UNITY_END();
+}
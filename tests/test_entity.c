@@ -0,0 +1,173 @@
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "entity.h"
+#include "unity/unity.h"
+
+static struct EntityAllocator allocator;
+static struct EntityComponents components;
+
+void setUp(void)
+{
+	initArena();
+	entityAllocatorInit(&allocator);
+	entityComponentsInit(&components);
+}
+
+void tearDown(void)
+{
+	cleanupArena();
+}
+
+void testCreate(void)
+{
+	EntityId a = entityCreate(&allocator);
+	EntityId b = entityCreate(&allocator);
+
+	TEST_ASSERT_NOT_EQUAL(ENTITY_ID_NONE, a);
+	TEST_ASSERT_NOT_EQUAL(a, b);
+	TEST_ASSERT_NOT_EQUAL(0, ENTITY_ID_INDEX(a));
+	TEST_ASSERT_TRUE(entityIsAlive(&allocator, a));
+	TEST_ASSERT_TRUE(entityIsAlive(&allocator, b));
+	TEST_ASSERT_EQUAL_UINT16(2, allocator.count);
+	TEST_ASSERT_EQUAL_UINT32(a, entityGetId(&allocator, ENTITY_ID_INDEX(a)));
+}
+
+void testNoneNeverAlive(void)
+{
+	TEST_ASSERT_FALSE(entityIsAlive(&allocator, ENTITY_ID_NONE));
+	TEST_ASSERT_FALSE(entityDestroy(&allocator, ENTITY_ID_NONE));
+}
+
+void testFreeSlotNotAlive(void)
+{
+	/* Slot 1 is free, with the generation its next owner will get */
+	TEST_ASSERT_FALSE(entityIsAlive(&allocator, 1));
+}
+
+void testDestroyStale(void)
+{
+	EntityId a = entityCreate(&allocator);
+
+	TEST_ASSERT_TRUE(entityDestroy(&allocator, a));
+	TEST_ASSERT_FALSE(entityIsAlive(&allocator, a));
+	TEST_ASSERT_FALSE(entityDestroy(&allocator, a));
+	TEST_ASSERT_EQUAL_UINT16(0, allocator.count);
+}
+
+void testReuseBumpsGeneration(void)
+{
+	EntityId a = entityCreate(&allocator);
+	entityDestroy(&allocator, a);
+	EntityId b = entityCreate(&allocator);
+
+	TEST_ASSERT_EQUAL_UINT16(ENTITY_ID_INDEX(a), ENTITY_ID_INDEX(b));
+	TEST_ASSERT_NOT_EQUAL(a, b);
+	TEST_ASSERT_FALSE(entityIsAlive(&allocator, a));
+	TEST_ASSERT_TRUE(entityIsAlive(&allocator, b));
+}
+
+void testFull(void)
+{
+	for (size_t i = 1; i < MAX_ENTITIES; i++) {
+		TEST_ASSERT_NOT_EQUAL(ENTITY_ID_NONE, entityCreate(&allocator));
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(ENTITY_ID_NONE, entityCreate(&allocator));
+	TEST_ASSERT_EQUAL_UINT16(MAX_ENTITIES - 1, allocator.count);
+}
+
+void testDenseStaysPacked(void)
+{
+	static EntityId ids[MAX_ENTITIES];
+	static bool alive[MAX_ENTITIES];
+	u32 state = 99;
+
+	for (size_t i = 0; i < 20000; i++) {
+		state = state * 1664525u + 1013904223u;
+		size_t slot = (state >> 8) % MAX_ENTITIES;
+
+		if (alive[slot]) {
+			TEST_ASSERT_TRUE(entityDestroy(&allocator, ids[slot]));
+			alive[slot] = false;
+		} else {
+			ids[slot] = entityCreate(&allocator);
+			alive[slot] = ids[slot] != ENTITY_ID_NONE;
+		}
+	}
+
+	size_t liveCount = 0;
+	for (size_t slot = 0; slot < MAX_ENTITIES; slot++) {
+		if (alive[slot]) {
+			TEST_ASSERT_TRUE(entityIsAlive(&allocator, ids[slot]));
+			liveCount++;
+		}
+	}
+	TEST_ASSERT_EQUAL_UINT16(liveCount, allocator.count);
+
+	/* Every packed entity is alive and appears once */
+	static bool seen[MAX_ENTITIES];
+	for (u16 i = 0; i < allocator.count; i++) {
+		EntityIdx entity = allocator.dense[i];
+		TEST_ASSERT_FALSE(seen[entity]);
+		seen[entity] = true;
+		TEST_ASSERT_TRUE(entityIsAlive(&allocator,
+					       entityGetId(&allocator, entity)));
+	}
+}
+
+void testSpawnReservesChunks(void)
+{
+	EntityId id = ENTITY_ID_NONE;
+
+	for (size_t i = 1; i <= ENTITY_CHUNK_SIZE; i++) {
+		id = entitySpawn(&allocator, &components);
+	}
+
+	/* The last one is the first of the second chunk */
+	TEST_ASSERT_EQUAL_UINT16(ENTITY_CHUNK_SIZE, ENTITY_ID_INDEX(id));
+	TEST_ASSERT_EQUAL_UINT16(2, components.chunkCount);
+	TEST_ASSERT_EQUAL_UINT(0, (uintptr_t)components.chunks[1] % 64);
+}
+
+void testSpawnClearsColumns(void)
+{
+	EntityId a = entitySpawn(&allocator, &components);
+	EntityIdx entity = ENTITY_ID_INDEX(a);
+
+	ENTITY(&components, healths, entity) = 12.0f;
+	ENTITY(&components, types, entity) = TYPE_DEMON;
+	ENTITY_COLD(&components, names, entity) = 3;
+	entityDestroy(&allocator, a);
+
+	EntityId b = entitySpawn(&allocator, &components);
+	TEST_ASSERT_EQUAL_UINT16(entity, ENTITY_ID_INDEX(b));
+	TEST_ASSERT_EQUAL_FLOAT(0.0f, ENTITY(&components, healths, entity));
+	TEST_ASSERT_EQUAL_UINT8(TYPE_NONE, ENTITY(&components, types, entity));
+	TEST_ASSERT_EQUAL_UINT32(SYMBOL_NONE,
+				 ENTITY_COLD(&components, names, entity));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Ids */
+	RUN_TEST(testCreate);
+	RUN_TEST(testNoneNeverAlive);
+	RUN_TEST(testFreeSlotNotAlive);
+	RUN_TEST(testDestroyStale);
+	RUN_TEST(testReuseBumpsGeneration);
+	RUN_TEST(testFull);
+
+	/* Dense iteration */
+	RUN_TEST(testDenseStaysPacked);
+
+	/* Components */
+	RUN_TEST(testSpawnReservesChunks);
+	RUN_TEST(testSpawnClearsColumns);
+
+	return UNITY_END();
+}
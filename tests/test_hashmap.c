@@ -0,0 +1,203 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "common.h"
+#include "hashmap/hashmap.h"
+#include "unity/unity.h"
+
+/* Every key lands in the same group, to exercise probing */
+static u64 hashCollide(u32 key)
+{
+	(void)key;
+	return 0x2A;
+}
+
+HASHMAP_DECLARE(CollideMap, collide_map, u32, u32)
+HASHMAP_DEFINE(CollideMap, collide_map, u32, u32, hashCollide, equalU32)
+
+static StringMap strings;
+static U32Map numbers;
+
+void setUp(void)
+{
+	string_map_init(&strings);
+	u32_map_init(&numbers);
+}
+
+void tearDown(void)
+{
+	string_map_free(&strings);
+	u32_map_free(&numbers);
+}
+
+void testEmpty(void)
+{
+	TEST_ASSERT_NULL(string_map_get(&strings, "jerry"));
+	TEST_ASSERT_FALSE(string_map_has(&strings, "jerry"));
+	TEST_ASSERT_FALSE(string_map_remove(&strings, "jerry"));
+	TEST_ASSERT_EQUAL_size_t(0, strings.size);
+}
+
+void testPutGet(void)
+{
+	TEST_ASSERT_TRUE(string_map_put(&strings, "kobold", 3));
+	TEST_ASSERT_TRUE(string_map_put(&strings, "skeleton", 7));
+
+	TEST_ASSERT_EQUAL_UINT32(3, *string_map_get(&strings, "kobold"));
+	TEST_ASSERT_EQUAL_UINT32(7, *string_map_get(&strings, "skeleton"));
+	TEST_ASSERT_EQUAL_size_t(2, strings.size);
+}
+
+void testKeysCompareByContent(void)
+{
+	char key[] = "look";
+
+	string_map_put(&strings, "look", 1);
+	TEST_ASSERT_EQUAL_UINT32(1, *string_map_get(&strings, key));
+}
+
+void testOverwrite(void)
+{
+	TEST_ASSERT_TRUE(string_map_put(&strings, "eat", 1));
+	TEST_ASSERT_FALSE(string_map_put(&strings, "eat", 2));
+
+	TEST_ASSERT_EQUAL_UINT32(2, *string_map_get(&strings, "eat"));
+	TEST_ASSERT_EQUAL_size_t(1, strings.size);
+}
+
+void testRemove(void)
+{
+	string_map_put(&strings, "eat", 1);
+	string_map_put(&strings, "slap", 2);
+
+	TEST_ASSERT_TRUE(string_map_remove(&strings, "eat"));
+	TEST_ASSERT_FALSE(string_map_has(&strings, "eat"));
+	TEST_ASSERT_TRUE(string_map_has(&strings, "slap"));
+	TEST_ASSERT_EQUAL_size_t(1, strings.size);
+}
+
+void testGrow(void)
+{
+	enum { COUNT = 10000 };
+
+	for (u32 i = 0; i < COUNT; i++) {
+		TEST_ASSERT_TRUE(u32_map_put(&numbers, i, i * 3));
+	}
+
+	TEST_ASSERT_EQUAL_size_t(COUNT, numbers.size);
+	TEST_ASSERT_TRUE(numbers.capacity - numbers.capacity / 8 >= COUNT);
+
+	for (u32 i = 0; i < COUNT; i++) {
+		u32 *value = u32_map_get(&numbers, i);
+		TEST_ASSERT_NOT_NULL(value);
+		TEST_ASSERT_EQUAL_UINT32(i * 3, *value);
+	}
+
+	TEST_ASSERT_NULL(u32_map_get(&numbers, COUNT));
+}
+
+void testChurnReusesTombstones(void)
+{
+	u32_map_reserve(&numbers, 100);
+	size_t capacity = numbers.capacity;
+
+	for (u32 i = 0; i < 100000; i++) {
+		u32_map_put(&numbers, i, i);
+		if (i >= 50) {
+			TEST_ASSERT_TRUE(u32_map_remove(&numbers, i - 50));
+		}
+	}
+
+	TEST_ASSERT_EQUAL_size_t(50, numbers.size);
+	TEST_ASSERT_EQUAL_size_t(capacity, numbers.capacity);
+
+	for (u32 i = 100000 - 50; i < 100000; i++) {
+		TEST_ASSERT_EQUAL_UINT32(i, *u32_map_get(&numbers, i));
+	}
+}
+
+void testCollisions(void)
+{
+	CollideMap map = { 0 };
+
+	for (u32 i = 0; i < 100; i++) {
+		collide_map_put(&map, i, i + 1);
+	}
+
+	for (u32 i = 0; i < 100; i += 3) {
+		TEST_ASSERT_TRUE(collide_map_remove(&map, i));
+	}
+
+	for (u32 i = 0; i < 100; i++) {
+		u32 *value = collide_map_get(&map, i);
+		if (i % 3 == 0) {
+			TEST_ASSERT_NULL(value);
+		} else {
+			TEST_ASSERT_NOT_NULL(value);
+			TEST_ASSERT_EQUAL_UINT32(i + 1, *value);
+		}
+	}
+
+	collide_map_free(&map);
+}
+
+void testClear(void)
+{
+	for (u32 i = 0; i < 100; i++) {
+		u32_map_put(&numbers, i, i);
+	}
+
+	size_t capacity = numbers.capacity;
+	u32_map_clear(&numbers);
+
+	TEST_ASSERT_EQUAL_size_t(0, numbers.size);
+	TEST_ASSERT_EQUAL_size_t(capacity, numbers.capacity);
+	TEST_ASSERT_FALSE(u32_map_has(&numbers, 5));
+}
+
+void testIterate(void)
+{
+	u32 sum = 0;
+
+	for (u32 i = 1; i <= 100; i++) {
+		u32_map_put(&numbers, i, i);
+	}
+	u32_map_remove(&numbers, 100);
+
+	size_t cursor = 0;
+	u32 key = 0;
+	u32 *value = NULL;
+	int visited = 0;
+	while (u32_map_next(&numbers, &cursor, &key, &value)) {
+		TEST_ASSERT_EQUAL_UINT32(key, *value);
+		sum += key;
+		visited++;
+	}
+
+	TEST_ASSERT_EQUAL_INT(99, visited);
+	TEST_ASSERT_EQUAL_UINT32(99 * 100 / 2, sum);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Basic operations */
+	RUN_TEST(testEmpty);
+	RUN_TEST(testPutGet);
+	RUN_TEST(testKeysCompareByContent);
+	RUN_TEST(testOverwrite);
+	RUN_TEST(testRemove);
+	RUN_TEST(testClear);
+	RUN_TEST(testIterate);
+
+	/* Capacity */
+	RUN_TEST(testGrow);
+	RUN_TEST(testChurnReusesTombstones);
+	RUN_TEST(testCollisions);
+
+	return UNITY_END();
+}
@@ -0,0 +1,128 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "common.h"
+#include "intern.h"
+#include "thread.h"
+#include "unity/unity.h"
+
+void setUp(void)
+{
+	initArena();
+	initIntern();
+}
+
+void tearDown(void)
+{
+	cleanupIntern();
+	cleanupArena();
+}
+
+void testEmpty(void)
+{
+	TEST_ASSERT_EQUAL_UINT32(0, internCount());
+	TEST_ASSERT_EQUAL_STRING("", symbolString(SYMBOL_NONE));
+	TEST_ASSERT_EQUAL_UINT32(SYMBOL_NONE, internFind("goblin"));
+}
+
+void testInternReturnsSameSymbol(void)
+{
+	char copy[] = "goblin";
+
+	Symbol first = intern("goblin");
+	Symbol second = intern(copy);
+
+	TEST_ASSERT_NOT_EQUAL(SYMBOL_NONE, first);
+	TEST_ASSERT_EQUAL_UINT32(first, second);
+	TEST_ASSERT_EQUAL_UINT32(1, internCount());
+}
+
+void testDistinctStrings(void)
+{
+	Symbol goblin = intern("goblin");
+	Symbol kobold = intern("kobold");
+
+	TEST_ASSERT_NOT_EQUAL(goblin, kobold);
+	TEST_ASSERT_EQUAL_STRING("goblin", symbolString(goblin));
+	TEST_ASSERT_EQUAL_STRING("kobold", symbolString(kobold));
+	TEST_ASSERT_EQUAL_UINT32(kobold, internFind("kobold"));
+}
+
+void testStringIsCopiedOnce(void)
+{
+	char buffer[16] = "skeleton";
+
+	Symbol symbol = intern(buffer);
+	const char *stored = symbolString(symbol);
+	strcpy(buffer, "zombie");
+
+	TEST_ASSERT_TRUE(stored != buffer);
+	TEST_ASSERT_EQUAL_STRING("skeleton", symbolString(symbol));
+	TEST_ASSERT_EQUAL_PTR(stored, symbolString(intern("skeleton")));
+}
+
+void testManyStrings(void)
+{
+	char name[32];
+
+	for (int i = 0; i < 2000; i++) {
+		snprintf(name, sizeof(name), "rat %d", i);
+		TEST_ASSERT_EQUAL_UINT32(i + 1, intern(name));
+	}
+
+	for (int i = 0; i < 2000; i++) {
+		snprintf(name, sizeof(name), "rat %d", i);
+		TEST_ASSERT_EQUAL_UINT32(i + 1, intern(name));
+		TEST_ASSERT_EQUAL_STRING(name, symbolString(i + 1));
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(2000, internCount());
+}
+
+/* Interns like a system on the simulation thread, whose thread arena is reset
+ * after every tick */
+static int internOnThread(void *arg)
+{
+	Symbol *symbol = arg;
+
+	initThreadArena();
+	claimWorldMemory();
+	*symbol = intern("wraith");
+
+	resetThreadArena();
+	memset(arenaAlloc(64), 'x', 64);
+	cleanupThreadArena();
+
+	return 0;
+}
+
+void testSymbolsOutliveThreadArena(void)
+{
+	Symbol symbol = SYMBOL_NONE;
+	thrd_t thread;
+
+	TEST_ASSERT_EQUAL_INT(thrd_success,
+			      thrd_create(&thread, internOnThread, &symbol));
+	thrd_join(thread, NULL);
+	claimWorldMemory();
+
+	TEST_ASSERT_EQUAL_STRING("wraith", symbolString(symbol));
+	TEST_ASSERT_EQUAL_UINT32(symbol, intern("wraith"));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(testEmpty);
+	RUN_TEST(testInternReturnsSameSymbol);
+	RUN_TEST(testDistinctStrings);
+	RUN_TEST(testStringIsCopiedOnce);
+	RUN_TEST(testManyStrings);
+	RUN_TEST(testSymbolsOutliveThreadArena);
+
+	return UNITY_END();
+}
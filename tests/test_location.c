@@ -0,0 +1,186 @@
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "location.h"
+#include "unity/unity.h"
+
+/* Several chunks, so lists cross chunk boundaries */
+#define ENTITY_COUNT (3 * ENTITY_CHUNK_SIZE)
+
+static struct LocationIndex locations;
+static struct EntityComponents components;
+
+void setUp(void)
+{
+	initArena();
+	entityComponentsInit(&components);
+	entityComponentsReserve(&components, ENTITY_COUNT);
+	locationIndexInit(&locations);
+}
+
+void tearDown(void)
+{
+	cleanupArena();
+}
+
+/* Collect a room's entities, return how many */
+static size_t collect(RoomIdx room, EntityIdx *out, size_t max)
+{
+	struct LocationIterator iter = locationGetEntities(&locations, room);
+	EntityIdx entity = 0;
+	size_t count = 0;
+
+	while (locationIteratorNext(&iter, &entity)) {
+		TEST_ASSERT_TRUE(count < max);
+		out[count++] = entity;
+	}
+
+	return count;
+}
+
+/* Check the index against a full scan of the location column */
+static void assertMatchesScan(void)
+{
+	for (RoomIdx room = 1; room < MAX_ROOMS; room++) {
+		static EntityIdx found[ENTITY_COUNT];
+		size_t count = collect(room, found, ENTITY_COUNT);
+
+		size_t expected = 0;
+		for (size_t e = 1; e < ENTITY_COUNT; e++) {
+			expected += ENTITY(&components, location, e) == room;
+		}
+
+		TEST_ASSERT_EQUAL_size_t(expected, count);
+		TEST_ASSERT_EQUAL_UINT32(expected, locationCount(&locations, room));
+		for (size_t i = 0; i < count; i++) {
+			TEST_ASSERT_EQUAL_UINT16(
+				room, ENTITY(&components, location, found[i]));
+		}
+	}
+}
+
+void testEmpty(void)
+{
+	EntityIdx found[1];
+
+	TEST_ASSERT_EQUAL_size_t(0, collect(1, found, 1));
+	TEST_ASSERT_EQUAL_UINT32(0, locationCount(&locations, 1));
+}
+
+void testMove(void)
+{
+	EntityIdx found[4];
+
+	locationMove(&locations, &components, 3, 5);
+	locationMove(&locations, &components, 7, 5);
+	locationMove(&locations, &components, 9, 6);
+
+	TEST_ASSERT_EQUAL_UINT16(5, ENTITY(&components, location, 3));
+	TEST_ASSERT_EQUAL_size_t(2, collect(5, found, 4));
+	TEST_ASSERT_EQUAL_UINT16(7, found[0]);
+	TEST_ASSERT_EQUAL_UINT16(3, found[1]);
+	TEST_ASSERT_EQUAL_size_t(1, collect(6, found, 4));
+	TEST_ASSERT_EQUAL_UINT16(9, found[0]);
+
+	locationMove(&locations, &components, 7, 6);
+	TEST_ASSERT_EQUAL_size_t(1, collect(5, found, 4));
+	TEST_ASSERT_EQUAL_UINT16(3, found[0]);
+	TEST_ASSERT_EQUAL_size_t(2, collect(6, found, 4));
+}
+
+void testMoveSameRoom(void)
+{
+	locationMove(&locations, &components, 3, 5);
+	locationMove(&locations, &components, 3, 5);
+
+	TEST_ASSERT_EQUAL_UINT32(1, locationCount(&locations, 5));
+}
+
+void testMoveToNowhere(void)
+{
+	EntityIdx found[4];
+
+	locationMove(&locations, &components, 3, 5);
+	locationMove(&locations, &components, 4, 5);
+	locationMove(&locations, &components, 5, 5);
+
+	/* Middle, head and tail of the list */
+	locationMove(&locations, &components, 4, 0);
+	locationMove(&locations, &components, 5, 0);
+	TEST_ASSERT_EQUAL_size_t(1, collect(5, found, 4));
+	TEST_ASSERT_EQUAL_UINT16(3, found[0]);
+
+	locationMove(&locations, &components, 3, 0);
+	TEST_ASSERT_EQUAL_size_t(0, collect(5, found, 4));
+	TEST_ASSERT_EQUAL_UINT16(0, ENTITY(&components, location, 3));
+}
+
+void testMoveWhileIterating(void)
+{
+	for (EntityIdx e = 1; e <= 10; e++) {
+		locationMove(&locations, &components, e, 2);
+	}
+
+	struct LocationIterator iter = locationGetEntities(&locations, 2);
+	EntityIdx entity = 0;
+	size_t visited = 0;
+	while (locationIteratorNext(&iter, &entity)) {
+		locationMove(&locations, &components, entity, 3);
+		visited++;
+	}
+
+	TEST_ASSERT_EQUAL_size_t(10, visited);
+	TEST_ASSERT_EQUAL_UINT32(0, locationCount(&locations, 2));
+	TEST_ASSERT_EQUAL_UINT32(10, locationCount(&locations, 3));
+}
+
+void testBuild(void)
+{
+	EntityIdx found[4];
+
+	ENTITY(&components, location, 2) = 4;
+	ENTITY(&components, location, ENTITY_CHUNK_SIZE + 8) = 4;
+	ENTITY(&components, location, 5) = 1;
+
+	locationIndexBuild(&locations, &components);
+
+	TEST_ASSERT_EQUAL_size_t(2, collect(4, found, 4));
+	TEST_ASSERT_EQUAL_UINT16(2, found[0]);
+	TEST_ASSERT_EQUAL_UINT16(ENTITY_CHUNK_SIZE + 8, found[1]);
+	assertMatchesScan();
+}
+
+void testRandomMovesMatchScan(void)
+{
+	u32 state = 12345;
+
+	for (size_t i = 0; i < 20000; i++) {
+		state = state * 1664525u + 1013904223u;
+		EntityIdx entity = 1 + (state >> 8) % (ENTITY_COUNT - 1);
+		RoomIdx room = (state >> 20) % MAX_ROOMS;
+
+		locationMove(&locations, &components, entity, room);
+	}
+
+	assertMatchesScan();
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Moves */
+	RUN_TEST(testEmpty);
+	RUN_TEST(testMove);
+	RUN_TEST(testMoveSameRoom);
+	RUN_TEST(testMoveToNowhere);
+	RUN_TEST(testMoveWhileIterating);
+
+	/* Consistency with the location column */
+	RUN_TEST(testBuild);
+	RUN_TEST(testRandomMovesMatchScan);
+
+	return UNITY_END();
+}
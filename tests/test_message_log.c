@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "message_log.h"
+#include "unity/unity.h"
+
+#define HISTORY_PATH "test_message_log.history"
+
+static struct MessageLog messageLog;
+
+void setUp(void)
+{
+	TEST_ASSERT_EQUAL_INT(ERR_OK, messageLogInit(&messageLog, HISTORY_PATH));
+}
+
+void tearDown(void)
+{
+	messageLogCleanup(&messageLog);
+	remove(HISTORY_PATH);
+}
+
+/* Longest message, ending with its index so each one is different */
+static void formatLong(char *buffer, u64 index)
+{
+	memset(buffer, 'a' + (char)(index % 26), MESSAGE_LOG_MAX_LENGTH);
+	buffer[MESSAGE_LOG_MAX_LENGTH] = '\0';
+	snprintf(buffer + MESSAGE_LOG_MAX_LENGTH - 8, 9, "%08u",
+		 (unsigned)index);
+}
+
+void testPushGet(void)
+{
+	TEST_ASSERT_EQUAL_INT(ERR_OK, messageLogPush(&messageLog, "Eat"));
+	TEST_ASSERT_EQUAL_INT(ERR_OK, messageLogPush(&messageLog, "Slap"));
+
+	TEST_ASSERT_EQUAL_UINT64(2, messageLogCount(&messageLog));
+	TEST_ASSERT_EQUAL_STRING("Eat", messageLogGet(&messageLog, 0));
+	TEST_ASSERT_EQUAL_STRING("Slap", messageLogGet(&messageLog, 1));
+	TEST_ASSERT_NULL(messageLogGet(&messageLog, 2));
+}
+
+void testLongMessageCut(void)
+{
+	char text[MESSAGE_LOG_MAX_LENGTH + 100];
+	memset(text, 'x', sizeof(text) - 1);
+	text[sizeof(text) - 1] = '\0';
+
+	messageLogPush(&messageLog, text);
+
+	TEST_ASSERT_EQUAL_size_t(MESSAGE_LOG_MAX_LENGTH,
+				 strlen(messageLogGet(&messageLog, 0)));
+}
+
+/* A two byte character crossing the limit is dropped whole */
+void testLongMessageCutOnCharacter(void)
+{
+	char text[MESSAGE_LOG_MAX_LENGTH + 2];
+	memset(text, 'x', MESSAGE_LOG_MAX_LENGTH - 1);
+	memcpy(&text[MESSAGE_LOG_MAX_LENGTH - 1], "\xC3\xA9", 3);
+
+	messageLogPush(&messageLog, text);
+
+	text[MESSAGE_LOG_MAX_LENGTH - 1] = '\0';
+	TEST_ASSERT_EQUAL_STRING(text, messageLogGet(&messageLog, 0));
+}
+
+void testRingBoundedByEntries(void)
+{
+	char text[32];
+	u64 count = MESSAGE_LOG_RING_ENTRIES * 3 + 17;
+
+	for (u64 i = 0; i < count; i++) {
+		snprintf(text, sizeof(text), "message %u", (unsigned)i);
+		messageLogPush(&messageLog, text);
+	}
+
+	TEST_ASSERT_EQUAL_UINT64(count - MESSAGE_LOG_RING_ENTRIES, messageLog.first);
+
+	/* Newest first, then back from the history */
+	for (u64 i = count; i-- > 0;) {
+		snprintf(text, sizeof(text), "message %u", (unsigned)i);
+		TEST_ASSERT_EQUAL_STRING(text, messageLogGet(&messageLog, i));
+	}
+}
+
+void testRingBoundedByBytes(void)
+{
+	char text[MESSAGE_LOG_MAX_LENGTH + 1];
+	u64 count = 1000;
+
+	for (u64 i = 0; i < count; i++) {
+		formatLong(text, i);
+		messageLogPush(&messageLog, text);
+	}
+
+	u64 kept = count - messageLog.first;
+	TEST_ASSERT_TRUE(kept < MESSAGE_LOG_RING_ENTRIES);
+	TEST_ASSERT_TRUE(kept * (MESSAGE_LOG_MAX_LENGTH + 1)
+			 <= MESSAGE_LOG_RING_BYTES);
+
+	for (u64 i = 0; i < count; i++) {
+		formatLong(text, i);
+		TEST_ASSERT_EQUAL_STRING(text, messageLogGet(&messageLog, i));
+	}
+}
+
+void testPagesReadAgain(void)
+{
+	char text[MESSAGE_LOG_MAX_LENGTH + 1];
+	u64 count = MESSAGE_LOG_PAGE_ENTRIES * (MESSAGE_LOG_PAGE_SLOTS + 2)
+		+ MESSAGE_LOG_RING_BYTES / sizeof(text);
+
+	for (u64 i = 0; i < count; i++) {
+		formatLong(text, i);
+		messageLogPush(&messageLog, text);
+	}
+
+	/* More pages than slots, twice */
+	for (int pass = 0; pass < 2; pass++) {
+		for (u64 i = 0; i < messageLog.first; i += MESSAGE_LOG_PAGE_ENTRIES / 2) {
+			formatLong(text, i);
+			TEST_ASSERT_EQUAL_STRING(text, messageLogGet(&messageLog, i));
+		}
+	}
+}
+
+void testHistoryReadable(void)
+{
+	messageLogPush(&messageLog, "Eat");
+	messageLogPush(&messageLog, "Sleep");
+
+	FILE *file = fopen(HISTORY_PATH, "rb");
+	TEST_ASSERT_NOT_NULL(file);
+
+	char contents[32] = { 0 };
+	size_t read = fread(contents, 1, sizeof(contents) - 1, file);
+	fclose(file);
+
+	TEST_ASSERT_EQUAL_size_t(10, read);
+	TEST_ASSERT_EQUAL_STRING("Eat\nSleep\n", contents);
+}
+
+void testWithoutHistory(void)
+{
+	messageLogCleanup(&messageLog);
+
+	/* The directory doesn't exist */
+	TEST_ASSERT_EQUAL_INT(
+		ERR_FILE_WRITING_FAILED,
+		messageLogInit(&messageLog, "missing/" HISTORY_PATH));
+	TEST_ASSERT_TRUE(messageLog.historyFailed);
+
+	for (u64 i = 0; i < MESSAGE_LOG_RING_ENTRIES + 1; i++) {
+		TEST_ASSERT_EQUAL_INT(ERR_OK,
+				      messageLogPush(&messageLog, "Eat"));
+	}
+
+	/* Only the ring is left */
+	TEST_ASSERT_NULL(messageLogGet(&messageLog, 0));
+	TEST_ASSERT_EQUAL_STRING(
+		"Eat", messageLogGet(&messageLog, MESSAGE_LOG_RING_ENTRIES));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(testPushGet);
+	RUN_TEST(testLongMessageCut);
+	RUN_TEST(testLongMessageCutOnCharacter);
+	RUN_TEST(testRingBoundedByEntries);
+	RUN_TEST(testRingBoundedByBytes);
+	RUN_TEST(testPagesReadAgain);
+	RUN_TEST(testHistoryReadable);
+	RUN_TEST(testWithoutHistory);
+
+	return UNITY_END();
+}
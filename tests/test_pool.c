@@ -0,0 +1,231 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "common.h"
+#include "list/list.h"
+#include "memstats.h"
+#include "pool/pool_base.h"
+#include "unity/unity.h"
+
+struct Sample {
+	int value;
+	char padding[12];
+};
+
+POOL_DECLARE(SamplePool, sample_pool, struct Sample)
+POOL_DEFINE(SamplePool, sample_pool, struct Sample)
+
+static SamplePool pool;
+
+void setUp(void)
+{
+	sample_pool_init(&pool);
+	initListPool();
+}
+
+void tearDown(void)
+{
+	sample_pool_free(&pool);
+	cleanupListPool();
+}
+
+void testAllocZeroed(void)
+{
+	PoolHandle handle = sample_pool_alloc(&pool);
+	TEST_ASSERT_NOT_EQUAL(POOL_NULL_HANDLE, handle);
+
+	struct Sample *sample = sample_pool_get(&pool, handle);
+	TEST_ASSERT_NOT_NULL(sample);
+	TEST_ASSERT_EQUAL_INT(0, sample->value);
+	TEST_ASSERT_EQUAL_UINT32(1, pool.count);
+}
+
+void testNullHandleInvalid(void)
+{
+	TEST_ASSERT_FALSE(sample_pool_is_valid(&pool, POOL_NULL_HANDLE));
+	TEST_ASSERT_NULL(sample_pool_get(&pool, POOL_NULL_HANDLE));
+
+	(void)sample_pool_alloc(&pool);
+	TEST_ASSERT_FALSE(sample_pool_is_valid(&pool, POOL_NULL_HANDLE));
+}
+
+void testStaleHandle(void)
+{
+	PoolHandle handle = sample_pool_alloc(&pool);
+
+	TEST_ASSERT_TRUE(sample_pool_release(&pool, handle));
+	TEST_ASSERT_FALSE(sample_pool_is_valid(&pool, handle));
+	TEST_ASSERT_NULL(sample_pool_get(&pool, handle));
+	TEST_ASSERT_FALSE(sample_pool_release(&pool, handle));
+	TEST_ASSERT_EQUAL_UINT32(0, pool.count);
+}
+
+void testSlotReuseBumpsGeneration(void)
+{
+	PoolHandle first = sample_pool_alloc(&pool);
+	sample_pool_release(&pool, first);
+	PoolHandle second = sample_pool_alloc(&pool);
+
+	TEST_ASSERT_EQUAL_UINT32(POOL_HANDLE_INDEX(first),
+				 POOL_HANDLE_INDEX(second));
+	TEST_ASSERT_NOT_EQUAL(first, second);
+	TEST_ASSERT_NULL(sample_pool_get(&pool, first));
+	TEST_ASSERT_NOT_NULL(sample_pool_get(&pool, second));
+}
+
+void testGenerationWrapSkipsZero(void)
+{
+	PoolHandle handle = sample_pool_alloc(&pool);
+
+	for (u32 i = 0; i < POOL_GENERATION_MASK * 2; i++) {
+		sample_pool_release(&pool, handle);
+		handle = sample_pool_alloc(&pool);
+		TEST_ASSERT_NOT_EQUAL(0, POOL_HANDLE_GENERATION(handle));
+		TEST_ASSERT_TRUE(sample_pool_is_valid(&pool, handle));
+	}
+}
+
+void testGrowKeepsAddressesStable(void)
+{
+	enum { COUNT = POOL_CHUNK_SIZE * 40 };
+	static PoolHandle handles[COUNT];
+	static struct Sample *addresses[COUNT];
+
+	for (int i = 0; i < COUNT; i++) {
+		handles[i] = sample_pool_alloc(&pool);
+		TEST_ASSERT_NOT_EQUAL(POOL_NULL_HANDLE, handles[i]);
+		addresses[i] = sample_pool_get(&pool, handles[i]);
+		addresses[i]->value = i;
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(COUNT, pool.count);
+	TEST_ASSERT_EQUAL_UINT32(40, pool.chunkCount);
+
+	for (int i = 0; i < COUNT; i++) {
+		TEST_ASSERT_EQUAL_PTR(addresses[i],
+				      sample_pool_get(&pool, handles[i]));
+		TEST_ASSERT_EQUAL_INT(i, addresses[i]->value);
+	}
+}
+
+void testHandleOf(void)
+{
+	PoolHandle handle = sample_pool_alloc(&pool);
+	struct Sample *sample = sample_pool_get(&pool, handle);
+	struct Sample outside = { 0 };
+
+	TEST_ASSERT_EQUAL_UINT32(handle, sample_pool_handle_of(&pool, sample));
+	TEST_ASSERT_EQUAL_UINT32(POOL_NULL_HANDLE,
+				 sample_pool_handle_of(&pool, &outside));
+	TEST_ASSERT_EQUAL_UINT32(POOL_NULL_HANDLE, sample_pool_handle_of(
+		&pool, (struct Sample *)((char *)sample + 1)));
+
+	sample_pool_release(&pool, handle);
+	TEST_ASSERT_EQUAL_UINT32(POOL_NULL_HANDLE,
+				 sample_pool_handle_of(&pool, sample));
+}
+
+void testIterateAlive(void)
+{
+	PoolHandle handles[10];
+
+	for (int i = 0; i < 10; i++) {
+		handles[i] = sample_pool_alloc(&pool);
+		sample_pool_get(&pool, handles[i])->value = i;
+	}
+
+	for (int i = 0; i < 10; i += 2) {
+		sample_pool_release(&pool, handles[i]);
+	}
+
+	u32 cursor = 0;
+	int visited = 0;
+	struct Sample *sample = NULL;
+	while ((sample = sample_pool_next(&pool, &cursor)) != NULL) {
+		TEST_ASSERT_EQUAL_INT(1, sample->value % 2);
+		visited++;
+	}
+
+	TEST_ASSERT_EQUAL_INT(5, visited);
+}
+
+void testManyLists(void)
+{
+	enum { COUNT = 4096 };
+	static List *lists[COUNT];
+
+	for (int i = 0; i < COUNT; i++) {
+		lists[i] = newList();
+		TEST_ASSERT_NOT_NULL(lists[i]);
+		list_push(lists[i], &lists[i]);
+	}
+
+	for (int i = 0; i < COUNT; i++) {
+		TEST_ASSERT_EQUAL_PTR(&lists[i], list_get(lists[i], 0));
+	}
+
+	for (int i = 0; i < COUNT; i += 2) {
+		freeList(lists[i]);
+	}
+}
+
+void testListHandleStale(void)
+{
+	ListHandle handle = newListHandle();
+	List *list = getList(handle);
+
+	TEST_ASSERT_NOT_NULL(list);
+	TEST_ASSERT_EQUAL_UINT32(handle, getListHandle(list));
+
+	list_push(list, NULL);
+	freeListHandle(handle);
+
+	TEST_ASSERT_NULL(getList(handle));
+	TEST_ASSERT_EQUAL_UINT32(POOL_NULL_HANDLE, getListHandle(list));
+
+	ListHandle reused = newListHandle();
+	TEST_ASSERT_NOT_EQUAL(handle, reused);
+	TEST_ASSERT_EQUAL_PTR(list, getList(reused));
+	TEST_ASSERT_EQUAL_size_t(0, VECTOR_SIZE(getList(reused)));
+}
+
+void testListPoolCountsHandles(void)
+{
+	/* Enough handles to grow the pool by several chunks */
+	enum { COUNT = 4 * POOL_CHUNK_SIZE + 1 };
+	size_t before = memStatsGet(MEM_TAG_LIST_POOL).allocCount;
+
+	for (int i = 0; i < COUNT; i++) {
+		newListHandle();
+	}
+
+	TEST_ASSERT_EQUAL_size_t(before + COUNT,
+				 memStatsGet(MEM_TAG_LIST_POOL).allocCount);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Handles */
+	RUN_TEST(testAllocZeroed);
+	RUN_TEST(testNullHandleInvalid);
+	RUN_TEST(testStaleHandle);
+	RUN_TEST(testSlotReuseBumpsGeneration);
+	RUN_TEST(testGenerationWrapSkipsZero);
+
+	/* Storage */
+	RUN_TEST(testGrowKeepsAddressesStable);
+	RUN_TEST(testHandleOf);
+	RUN_TEST(testIterateAlive);
+
+	/* List pool */
+	RUN_TEST(testManyLists);
+	RUN_TEST(testListHandleStale);
+	RUN_TEST(testListPoolCountsHandles);
+
+	return UNITY_END();
+}
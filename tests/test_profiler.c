@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "profiler.h"
+#include "unity/unity.h"
+
+#define TRACE_PATH "test_profiler_trace.json"
+
+void setUp(void)
+{
+	initProfiler();
+}
+
+void tearDown(void)
+{
+	remove(TRACE_PATH);
+}
+
+/* One frame per duration, then start the next so they are all finished */
+static void recordFrames(ProfileZone zone, const u64 *durations, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		profilerNextFrame();
+		profilerRecord(zone, 0, durations[i]);
+	}
+	profilerNextFrame();
+}
+
+void testNoSamples(void)
+{
+	struct ProfileStats stats = profilerStats(PROFILE_ZONE_LAYOUT);
+	TEST_ASSERT_EQUAL_size_t(0, stats.sampleCount);
+	TEST_ASSERT_EQUAL_UINT64(0, stats.max);
+}
+
+void testPercentiles(void)
+{
+	u64 durations[100];
+	for (size_t i = 0; i < ARRAY_LENGTH(durations); i++) {
+		/* Shuffled 1..100 */
+		durations[i] = (i * 37) % 100 + 1;
+	}
+	recordFrames(PROFILE_ZONE_VIEW, durations, ARRAY_LENGTH(durations));
+
+	struct ProfileStats stats = profilerStats(PROFILE_ZONE_VIEW);
+	TEST_ASSERT_EQUAL_size_t(100, stats.sampleCount);
+	TEST_ASSERT_EQUAL_UINT64(50, stats.p50);
+	TEST_ASSERT_EQUAL_UINT64(99, stats.p99);
+	TEST_ASSERT_EQUAL_UINT64(100, stats.max);
+}
+
+void testCurrentFrameExcluded(void)
+{
+	profilerNextFrame();
+	profilerRecord(PROFILE_ZONE_RENDER, 0, 10);
+
+	TEST_ASSERT_EQUAL_size_t(0, profilerStats(PROFILE_ZONE_RENDER).sampleCount);
+
+	profilerNextFrame();
+	TEST_ASSERT_EQUAL_size_t(1, profilerStats(PROFILE_ZONE_RENDER).sampleCount);
+}
+
+void testRepeatedZoneAddsUp(void)
+{
+	profilerNextFrame();
+	profilerRecord(PROFILE_ZONE_LAYOUT, 0, 10);
+	profilerRecord(PROFILE_ZONE_LAYOUT, 20, 5);
+	profilerNextFrame();
+
+	struct ProfileStats stats = profilerStats(PROFILE_ZONE_LAYOUT);
+	TEST_ASSERT_EQUAL_size_t(1, stats.sampleCount);
+	TEST_ASSERT_EQUAL_UINT64(15, stats.max);
+}
+
+void testFramesWithoutZoneSkipped(void)
+{
+	profilerNextFrame();
+	profilerRecord(PROFILE_ZONE_SIMULATION, 0, 7);
+	profilerNextFrame();
+	profilerNextFrame();
+	profilerNextFrame();
+
+	struct ProfileStats stats = profilerStats(PROFILE_ZONE_SIMULATION);
+	TEST_ASSERT_EQUAL_size_t(1, stats.sampleCount);
+	TEST_ASSERT_EQUAL_UINT64(7, stats.p50);
+}
+
+void testOldFramesForgotten(void)
+{
+	u64 slow = 1000;
+	recordFrames(PROFILE_ZONE_FRAME, &slow, 1);
+
+	u64 fast[PROFILER_FRAME_COUNT];
+	for (size_t i = 0; i < ARRAY_LENGTH(fast); i++) {
+		fast[i] = 1;
+	}
+	recordFrames(PROFILE_ZONE_FRAME, fast, ARRAY_LENGTH(fast));
+
+	struct ProfileStats stats = profilerStats(PROFILE_ZONE_FRAME);
+	TEST_ASSERT_EQUAL_size_t(PROFILER_FRAME_COUNT, stats.sampleCount);
+	TEST_ASSERT_EQUAL_UINT64(1, stats.max);
+}
+
+void testBeginEnd(void)
+{
+	profilerNextFrame();
+	u64 start = profilerBegin();
+	profilerEnd(PROFILE_ZONE_VIEW, start);
+	profilerNextFrame();
+
+	TEST_ASSERT_EQUAL_size_t(1, profilerStats(PROFILE_ZONE_VIEW).sampleCount);
+}
+
+static size_t countOccurrences(const char *haystack, const char *needle)
+{
+	size_t count = 0;
+
+	for (const char *at = strstr(haystack, needle); at != NULL;
+	     at = strstr(at + 1, needle)) {
+		count++;
+	}
+
+	return count;
+}
+
+static char *readTrace(void)
+{
+	long size = load_file(TRACE_PATH, NULL);
+	TEST_ASSERT_TRUE(size > 0);
+
+	char *trace = malloc_try((size_t)size);
+	load_file(TRACE_PATH, trace);
+	return trace;
+}
+
+void testDumpTrace(void)
+{
+	profilerRecord(PROFILE_ZONE_INIT, 1000, 2500);
+	profilerNextFrame();
+	profilerRecord(PROFILE_ZONE_SIMULATION, 4000, 500);
+
+	TEST_ASSERT_EQUAL(ERR_OK, profilerDumpTrace(TRACE_PATH));
+
+	char *trace = readTrace();
+	TEST_ASSERT_NOT_NULL(strstr(trace,
+		",{\"name\":\"init\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+		"\"ts\":1.000,\"dur\":2.500}"));
+	TEST_ASSERT_NOT_NULL(strstr(trace,
+		",{\"name\":\"simulation\",\"ph\":\"X\",\"pid\":1,\"tid\":2,"
+		"\"ts\":4.000,\"dur\":0.500}"));
+	TEST_ASSERT_NOT_NULL(strstr(trace, "]}\n"));
+	free(trace);
+}
+
+void testDumpTraceKeepsLatestEvents(void)
+{
+	for (size_t i = 0; i < PROFILER_EVENT_COUNT + 10; i++) {
+		profilerRecord(i < 10 ? PROFILE_ZONE_INIT : PROFILE_ZONE_VIEW, i, 1);
+	}
+
+	TEST_ASSERT_EQUAL(ERR_OK, profilerDumpTrace(TRACE_PATH));
+
+	char *trace = readTrace();
+	TEST_ASSERT_EQUAL_size_t(0, countOccurrences(trace, "\"init\""));
+	TEST_ASSERT_EQUAL_size_t(PROFILER_EVENT_COUNT,
+				 countOccurrences(trace, "\"view\""));
+	free(trace);
+}
+
+void testDumpTraceUnwritable(void)
+{
+	TEST_ASSERT_EQUAL(ERR_FILE_WRITING_FAILED,
+			  profilerDumpTrace("/nonexistent/trace.json"));
+}
+
+int main(void)
+{
+	laz_trace_init();
+	UNITY_BEGIN();
+
+	/* Percentiles */
+	RUN_TEST(testNoSamples);
+	RUN_TEST(testPercentiles);
+	RUN_TEST(testCurrentFrameExcluded);
+	RUN_TEST(testRepeatedZoneAddsUp);
+	RUN_TEST(testFramesWithoutZoneSkipped);
+	RUN_TEST(testOldFramesForgotten);
+	RUN_TEST(testBeginEnd);
+
+	/* Traces */
+	RUN_TEST(testDumpTrace);
+	RUN_TEST(testDumpTraceKeepsLatestEvents);
+	RUN_TEST(testDumpTraceUnwritable);
+
+	return UNITY_END();
+}
@@ -0,0 +1,197 @@
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "query.h"
+#include "unity/unity.h"
+
+/* Several chunks, so queries cross chunk boundaries */
+#define ENTITY_COUNT (3 * ENTITY_CHUNK_SIZE)
+
+static struct EntityComponents components;
+static EntityIdx found[ENTITY_COUNT];
+static EntityIdx expected[ENTITY_COUNT];
+
+void setUp(void)
+{
+	initArena();
+	entityComponentsInit(&components);
+	entityComponentsReserve(&components, ENTITY_COUNT);
+}
+
+void tearDown(void)
+{
+	cleanupArena();
+}
+
+static size_t referenceQuery(const struct EntityQuery *q, EntityIdx *out)
+{
+	size_t count = 0;
+
+	for (size_t i = 1; i < ENTITY_COUNT; i++) {
+		EntityType types = ENTITY(&components, types, i);
+
+		if ((types & q->allTypes) != q->allTypes) {
+			continue;
+		}
+		if (q->anyTypes != 0 && (types & q->anyTypes) == 0) {
+			continue;
+		}
+		if (q->room != 0 && ENTITY(&components, location, i) != q->room) {
+			continue;
+		}
+		if (q->minHealth > QUERY_ANY_HEALTH
+		    && !(ENTITY(&components, healths, i) > q->minHealth)) {
+			continue;
+		}
+
+		out[count++] = (EntityIdx)i;
+	}
+
+	return count;
+}
+
+static void assertMatchesReference(const struct EntityQuery *q)
+{
+	size_t count = entityQuery(&components, q, found);
+	size_t expectedCount = referenceQuery(q, expected);
+
+	TEST_ASSERT_EQUAL_size_t(expectedCount, count);
+	if (count > 0) {
+		TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, found, count);
+	}
+}
+
+static void fillRandom(u32 seed)
+{
+	u32 state = seed;
+
+	for (size_t i = 0; i < ENTITY_COUNT; i++) {
+		state = state * 1664525u + 1013904223u;
+		ENTITY(&components, types, i) = (EntityType)(state >> 24);
+		ENTITY(&components, location, i) = (EntityIdx)((state >> 8) % 8);
+		ENTITY(&components, healths, i) =
+			(float)((state >> 12) % 200) - 50.0f;
+	}
+}
+
+void testNullEntityNeverMatches(void)
+{
+	ENTITY(&components, types, 0) = TYPE_UNDEAD;
+	ENTITY(&components, healths, 0) = 10.0f;
+
+	struct EntityQuery q = { 0, 0, 0, QUERY_ANY_HEALTH };
+	size_t count = entityQuery(&components, &q, found);
+
+	TEST_ASSERT_EQUAL_size_t(ENTITY_COUNT - 1, count);
+	TEST_ASSERT_EQUAL_UINT16(1, found[0]);
+	TEST_ASSERT_EQUAL_UINT16(ENTITY_COUNT - 1, found[count - 1]);
+}
+
+void testAnyType(void)
+{
+	ENTITY(&components, types, 3) = TYPE_UNDEAD;
+	ENTITY(&components, types, 17) = TYPE_UNDEAD | TYPE_HUMAN;
+	ENTITY(&components, types, 40) = TYPE_HUMAN;
+	ENTITY(&components, types, ENTITY_COUNT - 1) = TYPE_DEMON;
+
+	struct EntityQuery q = {
+		TYPE_UNDEAD | TYPE_DEMON, 0, 0, QUERY_ANY_HEALTH
+	};
+	size_t count = entityQuery(&components, &q, found);
+
+	TEST_ASSERT_EQUAL_size_t(3, count);
+	TEST_ASSERT_EQUAL_UINT16(3, found[0]);
+	TEST_ASSERT_EQUAL_UINT16(17, found[1]);
+	TEST_ASSERT_EQUAL_UINT16(ENTITY_COUNT - 1, found[2]);
+}
+
+void testAllTypes(void)
+{
+	ENTITY(&components, types, 5) = TYPE_UNDEAD | TYPE_HUMAN;
+	ENTITY(&components, types, 6) = TYPE_UNDEAD;
+	ENTITY(&components, types, 7) = TYPE_UNDEAD | TYPE_HUMAN | TYPE_KOBOLD;
+
+	struct EntityQuery q = {
+		0, TYPE_UNDEAD | TYPE_HUMAN, 0, QUERY_ANY_HEALTH
+	};
+	size_t count = entityQuery(&components, &q, found);
+
+	TEST_ASSERT_EQUAL_size_t(2, count);
+	TEST_ASSERT_EQUAL_UINT16(5, found[0]);
+	TEST_ASSERT_EQUAL_UINT16(7, found[1]);
+}
+
+void testRoomAndHealth(void)
+{
+	ENTITY(&components, types, 9) = TYPE_BEAST;
+	ENTITY(&components, location, 9) = 4;
+	ENTITY(&components, healths, 9) = 5.0f;
+	ENTITY(&components, types, 10) = TYPE_BEAST;
+	ENTITY(&components, location, 10) = 4;
+	ENTITY(&components, healths, 10) = 0.0f;
+	ENTITY(&components, types, 11) = TYPE_BEAST;
+	ENTITY(&components, location, 11) = 3;
+	ENTITY(&components, healths, 11) = 5.0f;
+
+	struct EntityQuery q = { TYPE_BEAST, 0, 4, 0.0f };
+	size_t count = entityQuery(&components, &q, found);
+
+	TEST_ASSERT_EQUAL_size_t(1, count);
+	TEST_ASSERT_EQUAL_UINT16(9, found[0]);
+}
+
+void testRandomMatchesReference(void)
+{
+	for (u32 seed = 1; seed <= 16; seed++) {
+		fillRandom(seed);
+
+		struct EntityQuery queries[] = {
+			{ 0, 0, 0, QUERY_ANY_HEALTH },
+			{ TYPE_UNDEAD, 0, 0, QUERY_ANY_HEALTH },
+			{ TYPE_BEAST | TYPE_FUNGUS, 0, 3, QUERY_ANY_HEALTH },
+			{ 0, TYPE_HUMAN | TYPE_CELESTIAL, 0, 0.0f },
+			{ TYPE_DEMON, TYPE_KOBOLD, 7, 50.0f },
+			{ 0, 0, 5, -10.0f },
+		};
+
+		for (size_t i = 0; i < sizeof(queries) / sizeof(queries[0]); i++) {
+			assertMatchesReference(&queries[i]);
+		}
+	}
+}
+
+void testChunkQueriesAddUp(void)
+{
+	fillRandom(7);
+
+	struct EntityQuery q = { TYPE_UNDEAD, 0, 0, 0.0f };
+	size_t total = entityQuery(&components, &q, found);
+
+	size_t count = 0;
+	for (u16 chunk = 0; chunk < components.chunkCount; chunk++) {
+		count += entityQueryChunk(&components, chunk, &q,
+					  expected + count);
+	}
+
+	TEST_ASSERT_EQUAL_size_t(total, count);
+	TEST_ASSERT_EQUAL_UINT16_ARRAY(found, expected, count);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Filters */
+	RUN_TEST(testNullEntityNeverMatches);
+	RUN_TEST(testAnyType);
+	RUN_TEST(testAllTypes);
+	RUN_TEST(testRoomAndHealth);
+
+	/* Against a scalar scan */
+	RUN_TEST(testRandomMatchesReference);
+	RUN_TEST(testChunkQueriesAddUp);
+
+	return UNITY_END();
+}
@@ -0,0 +1,202 @@
+#include <stdatomic.h>
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "scheduler.h"
+#include "thread.h"
+#include "unity/unity.h"
+
+#define TEST_WORKERS 3
+
+static struct World world;
+static struct Scheduler scheduler;
+
+/* Order systems finished in */
+static atomic_uint finishedCount;
+static char finishOrder[MAX_SYSTEMS];
+
+static thrd_t mainThread;
+static atomic_bool ranOnMainThread;
+
+/* Set by the two systems meeting each other */
+static atomic_bool arrived[2];
+
+static void finish(char name)
+{
+	finishOrder[atomic_fetch_add(&finishedCount, 1)] = name;
+}
+
+static Error writeHealth(struct World *world)
+{
+	world->tickSeconds = 1.0f;
+	finish('w');
+	return ERR_OK;
+}
+
+static Error readHealth(struct World *world)
+{
+	/* Workers can't fail a test, the order shows stale reads */
+	finish(world->tickSeconds == 1.0f ? 'r' : '?');
+	return ERR_OK;
+}
+
+static Error onMainThread(struct World *world)
+{
+	(void)world;
+	atomic_store(&ranOnMainThread, thrd_equal(thrd_current(), mainThread));
+	finish('m');
+	return ERR_OK;
+}
+
+static Error failing(struct World *world)
+{
+	(void)world;
+	finish('f');
+	return ERR_OUT_OF_MEMORY;
+}
+
+/* Only returns once the other meeting system has started, which needs both
+ * to run at the same time */
+static bool meet(int self)
+{
+	atomic_store(&arrived[self], true);
+
+	for (int i = 0; i < 10000; i++) {
+		if (atomic_load(&arrived[!self])) {
+			return true;
+		}
+		thrd_sleep(&(struct timespec) { .tv_nsec = 100000 }, NULL);
+	}
+
+	return false;
+}
+
+static Error meetFirst(struct World *world)
+{
+	(void)world;
+	return meet(0) ? ERR_OK : ERR_RESOURCE_LOADING_FAILED;
+}
+
+static Error meetSecond(struct World *world)
+{
+	(void)world;
+	return meet(1) ? ERR_OK : ERR_RESOURCE_LOADING_FAILED;
+}
+
+void setUp(void)
+{
+	initArena();
+	mainThread = thrd_current();
+	atomic_store(&finishedCount, 0);
+	atomic_store(&ranOnMainThread, false);
+	atomic_store(&arrived[0], false);
+	atomic_store(&arrived[1], false);
+	memset(finishOrder, 0, sizeof(finishOrder));
+	memset(&world, 0, sizeof(world));
+}
+
+void tearDown(void)
+{
+	schedulerCleanup(&scheduler);
+	cleanupArena();
+}
+
+static void addSystem(SystemFunc run, ComponentMask reads,
+		      ComponentMask writes, SystemFlags flags)
+{
+	schedulerAddSystem(&scheduler, (struct System) {
+		.name = "test",
+		.run = run,
+		.reads = reads,
+		.writes = writes,
+		.flags = flags,
+	});
+}
+
+void testConflictsRunInOrder(void)
+{
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerInit(&scheduler, TEST_WORKERS));
+	addSystem(writeHealth, 0, COMPONENT_HEALTHS, 0);
+	addSystem(readHealth, COMPONENT_HEALTHS, 0, 0);
+
+	for (int tick = 0; tick < 100; tick++) {
+		atomic_store(&finishedCount, 0);
+		world.tickSeconds = 0.0f;
+
+		TEST_ASSERT_EQUAL(ERR_OK, schedulerRun(&scheduler, &world));
+		TEST_ASSERT_EQUAL_UINT(2, atomic_load(&finishedCount));
+		TEST_ASSERT_EQUAL_CHAR('w', finishOrder[0]);
+		TEST_ASSERT_EQUAL_CHAR('r', finishOrder[1]);
+	}
+}
+
+void testIndependentSystemsOverlap(void)
+{
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerInit(&scheduler, TEST_WORKERS));
+	addSystem(meetFirst, COMPONENT_TYPES, COMPONENT_HEALTHS, 0);
+	addSystem(meetSecond, COMPONENT_TYPES, COMPONENT_LOCATION, 0);
+
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerRun(&scheduler, &world));
+}
+
+void testMainThreadSystem(void)
+{
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerInit(&scheduler, TEST_WORKERS));
+	addSystem(writeHealth, 0, COMPONENT_HEALTHS, 0);
+	addSystem(onMainThread, COMPONENT_HEALTHS, 0, SYSTEM_MAIN_THREAD);
+
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerRun(&scheduler, &world));
+	TEST_ASSERT_TRUE(atomic_load(&ranOnMainThread));
+	TEST_ASSERT_EQUAL_CHAR('m', finishOrder[1]);
+}
+
+void testErrorSkipsDependents(void)
+{
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerInit(&scheduler, TEST_WORKERS));
+	addSystem(failing, 0, COMPONENT_HEALTHS, 0);
+	addSystem(readHealth, COMPONENT_HEALTHS, 0, 0);
+
+	TEST_ASSERT_EQUAL(ERR_OUT_OF_MEMORY, schedulerRun(&scheduler, &world));
+	TEST_ASSERT_EQUAL_UINT(1, atomic_load(&finishedCount));
+
+	/* The next tick runs again */
+	TEST_ASSERT_EQUAL(ERR_OUT_OF_MEMORY, schedulerRun(&scheduler, &world));
+	TEST_ASSERT_EQUAL_UINT(2, atomic_load(&finishedCount));
+}
+
+void testWithoutWorkers(void)
+{
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerInit(&scheduler, 0));
+	addSystem(writeHealth, 0, COMPONENT_HEALTHS, 0);
+	addSystem(onMainThread, COMPONENT_TYPES, 0, SYSTEM_MAIN_THREAD);
+	addSystem(readHealth, COMPONENT_HEALTHS, 0, 0);
+
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerRun(&scheduler, &world));
+	TEST_ASSERT_EQUAL_UINT(3, atomic_load(&finishedCount));
+	TEST_ASSERT_TRUE(atomic_load(&ranOnMainThread));
+}
+
+void testEmpty(void)
+{
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerInit(&scheduler, TEST_WORKERS));
+	TEST_ASSERT_EQUAL(ERR_OK, schedulerRun(&scheduler, &world));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Dependencies */
+	RUN_TEST(testConflictsRunInOrder);
+	RUN_TEST(testIndependentSystemsOverlap);
+	RUN_TEST(testMainThreadSystem);
+
+	/* Ticks */
+	RUN_TEST(testErrorSkipsDependents);
+	RUN_TEST(testWithoutWorkers);
+	RUN_TEST(testEmpty);
+
+	return UNITY_END();
+}
@@ -0,0 +1,109 @@
+#include <stdatomic.h>
+
+#include "snapshot.h"
+#include "thread.h"
+#include "unity/unity.h"
+
+#define PUBLISH_COUNT 200000
+
+static struct SnapshotBuffer buffer;
+static atomic_bool writerDone;
+
+void setUp(void)
+{
+	snapshotBufferInit(&buffer);
+	atomic_store(&writerDone, false);
+}
+
+void tearDown(void)
+{
+}
+
+static void publish(u64 tick)
+{
+	struct WorldSnapshot *snapshot = snapshotBufferBack(&buffer);
+	snapshot->tick = tick;
+	snapshot->gameSeconds = (double)tick;
+	snapshot->entityCount = (u16)tick;
+	snapshot->deathCount = tick * 3;
+	snapshotBufferPublish(&buffer);
+}
+
+static int writerMain(void *arg)
+{
+	(void)arg;
+
+	for (u64 tick = 1; tick <= PUBLISH_COUNT; tick++) {
+		publish(tick);
+	}
+	atomic_store(&writerDone, true);
+
+	return 0;
+}
+
+void testInitialSnapshotEmpty(void)
+{
+	const struct WorldSnapshot *snapshot = snapshotBufferRead(&buffer);
+	TEST_ASSERT_EQUAL_UINT64(0, snapshot->tick);
+}
+
+void testReadLatest(void)
+{
+	publish(1);
+	publish(2);
+	publish(3);
+
+	TEST_ASSERT_EQUAL_UINT64(3, snapshotBufferRead(&buffer)->tick);
+	/* Nothing new, the same snapshot again */
+	TEST_ASSERT_EQUAL_UINT64(3, snapshotBufferRead(&buffer)->tick);
+
+	publish(4);
+	TEST_ASSERT_EQUAL_UINT64(4, snapshotBufferRead(&buffer)->tick);
+}
+
+void testBuffersNotShared(void)
+{
+	publish(1);
+	const struct WorldSnapshot *read = snapshotBufferRead(&buffer);
+
+	/* The writer never gets the buffer being read */
+	for (u64 tick = 2; tick < 10; tick++) {
+		TEST_ASSERT_NOT_EQUAL(read, snapshotBufferBack(&buffer));
+		publish(tick);
+	}
+	TEST_ASSERT_EQUAL_UINT64(1, read->tick);
+}
+
+void testConcurrentReadsWhole(void)
+{
+	thrd_t writer;
+	TEST_ASSERT_EQUAL(thrd_success, thrd_create(&writer, writerMain, NULL));
+
+	u64 last = 0;
+	bool done = false;
+	while (!done) {
+		done = atomic_load(&writerDone);
+		const struct WorldSnapshot *snapshot = snapshotBufferRead(&buffer);
+
+		TEST_ASSERT_TRUE(snapshot->tick >= last);
+		TEST_ASSERT_TRUE((double)snapshot->tick == snapshot->gameSeconds);
+		TEST_ASSERT_EQUAL_UINT16((u16)snapshot->tick, snapshot->entityCount);
+		TEST_ASSERT_EQUAL_UINT64(snapshot->tick * 3, snapshot->deathCount);
+		last = snapshot->tick;
+	}
+
+	thrd_join(writer, NULL);
+	TEST_ASSERT_EQUAL_UINT64(PUBLISH_COUNT, snapshotBufferRead(&buffer)->tick);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(testInitialSnapshotEmpty);
+	RUN_TEST(testReadLatest);
+	RUN_TEST(testBuffersNotShared);
+	RUN_TEST(testConcurrentReadsWhole);
+
+	return UNITY_END();
+}
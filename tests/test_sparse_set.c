@@ -0,0 +1,209 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "sparse_set/sparse_set_base.h"
+#include "unity/unity.h"
+
+struct Sample {
+	int value;
+	char padding[12];
+};
+
+SPARSE_SET_DECLARE(SampleSet, sample_set, struct Sample)
+SPARSE_SET_DEFINE(SampleSet, sample_set, struct Sample)
+
+SPARSE_SET_DECLARE(FloatSet, float_set, float)
+SPARSE_SET_DEFINE(FloatSet, float_set, float)
+
+static SampleSet samples;
+static FloatSet floats;
+
+void setUp(void)
+{
+	sample_set_init(&samples);
+	float_set_init(&floats);
+}
+
+void tearDown(void)
+{
+	sample_set_free(&samples);
+	float_set_free(&floats);
+}
+
+void testAddZeroed(void)
+{
+	struct Sample *sample = sample_set_add(&samples, 42);
+	TEST_ASSERT_NOT_NULL(sample);
+	TEST_ASSERT_EQUAL_INT(0, sample->value);
+	TEST_ASSERT_TRUE(sample_set_has(&samples, 42));
+	TEST_ASSERT_FALSE(sample_set_has(&samples, 41));
+	TEST_ASSERT_EQUAL_UINT32(1, samples.index.size);
+}
+
+void testAddExistingKeepsValue(void)
+{
+	sample_set_add(&samples, 7)->value = 3;
+
+	struct Sample *again = sample_set_add(&samples, 7);
+	TEST_ASSERT_EQUAL_INT(3, again->value);
+	TEST_ASSERT_EQUAL_UINT32(1, samples.index.size);
+}
+
+void testGetMissing(void)
+{
+	TEST_ASSERT_NULL(sample_set_get(&samples, 0));
+	TEST_ASSERT_NULL(sample_set_get(&samples, SPARSE_SET_MAX_KEYS - 1));
+
+	sample_set_add(&samples, 1);
+	TEST_ASSERT_NULL(sample_set_get(&samples, 2));
+}
+
+void testPagesOnDemand(void)
+{
+	sample_set_add(&samples, SPARSE_SET_PAGE_SIZE * 3 + 5);
+
+	for (uint32_t i = 0; i < SPARSE_SET_PAGE_COUNT; i++) {
+		if (i == 3) {
+			TEST_ASSERT_NOT_NULL(samples.index.pages[i]);
+		} else {
+			TEST_ASSERT_NULL(samples.index.pages[i]);
+		}
+	}
+}
+
+void testRemoveSwapsLast(void)
+{
+	for (uint32_t key = 10; key < 15; key++) {
+		sample_set_add(&samples, key)->value = (int)key;
+	}
+
+	TEST_ASSERT_TRUE(sample_set_remove(&samples, 11));
+	TEST_ASSERT_FALSE(sample_set_remove(&samples, 11));
+	TEST_ASSERT_FALSE(sample_set_has(&samples, 11));
+	TEST_ASSERT_EQUAL_UINT32(4, samples.index.size);
+
+	/* The last key fills the hole */
+	TEST_ASSERT_EQUAL_UINT32(14, samples.index.keys[1]);
+	for (uint32_t key = 10; key < 15; key++) {
+		if (key != 11) {
+			TEST_ASSERT_EQUAL_INT((int)key, sample_set_get(&samples, key)->value);
+		}
+	}
+}
+
+void testRemoveLast(void)
+{
+	sample_set_add(&samples, 1);
+	sample_set_add(&samples, 2);
+
+	TEST_ASSERT_TRUE(sample_set_remove(&samples, 2));
+	TEST_ASSERT_TRUE(sample_set_has(&samples, 1));
+	TEST_ASSERT_TRUE(sample_set_remove(&samples, 1));
+	TEST_ASSERT_EQUAL_UINT32(0, samples.index.size);
+}
+
+void testManyKeys(void)
+{
+	for (uint32_t key = 0; key < SPARSE_SET_MAX_KEYS; key += 3) {
+		sample_set_add(&samples, key)->value = (int)key;
+	}
+	for (uint32_t key = 0; key < SPARSE_SET_MAX_KEYS; key += 6) {
+		TEST_ASSERT_TRUE(sample_set_remove(&samples, key));
+	}
+
+	for (uint32_t key = 0; key < SPARSE_SET_MAX_KEYS; key++) {
+		bool member = key % 3 == 0 && key % 6 != 0;
+		TEST_ASSERT_EQUAL(member, sample_set_has(&samples, key));
+		if (member) {
+			TEST_ASSERT_EQUAL_INT((int)key, sample_set_get(&samples, key)->value);
+		}
+	}
+}
+
+void testJoin(void)
+{
+	for (uint32_t key = 0; key < 100; key++) {
+		sample_set_add(&samples, key)->value = (int)key;
+	}
+	for (uint32_t key = 0; key < 100; key += 10) {
+		*float_set_add(&floats, key) = (float)key;
+	}
+	*float_set_add(&floats, 500) = 1.0f;
+
+	SparseSetJoin join;
+	sparse_set_join_init(&join, (const SparseSetIndex *[]) {
+		&samples.index, &floats.index }, 2);
+
+	/* The smaller set drives */
+	TEST_ASSERT_EQUAL_UINT32(1, join.driver);
+
+	uint32_t visited = 0;
+	while (sparse_set_join_next(&join)) {
+		TEST_ASSERT_EQUAL_UINT32(0, join.key % 10);
+		TEST_ASSERT_EQUAL_INT((int)join.key, samples.values[join.positions[0]].value);
+		TEST_ASSERT_EQUAL_FLOAT((float)join.key, floats.values[join.positions[1]]);
+		visited++;
+	}
+	TEST_ASSERT_EQUAL_UINT32(10, visited);
+}
+
+void testJoinEmpty(void)
+{
+	sample_set_add(&samples, 1);
+
+	SparseSetJoin join;
+	sparse_set_join_init(&join, (const SparseSetIndex *[]) {
+		&samples.index, &floats.index }, 2);
+	TEST_ASSERT_FALSE(sparse_set_join_next(&join));
+}
+
+void testJoinRemoveCurrent(void)
+{
+	for (uint32_t key = 0; key < 50; key++) {
+		sample_set_add(&samples, key);
+		*float_set_add(&floats, key) = 1.0f;
+	}
+
+	SparseSetJoin join;
+	sparse_set_join_init(&join, (const SparseSetIndex *[]) {
+		&samples.index, &floats.index }, 2);
+
+	uint32_t visited = 0;
+	while (sparse_set_join_next(&join)) {
+		if (join.key % 2 == 0) {
+			sample_set_remove(&samples, join.key);
+			float_set_remove(&floats, join.key);
+		}
+		visited++;
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(50, visited);
+	TEST_ASSERT_EQUAL_UINT32(25, samples.index.size);
+	TEST_ASSERT_EQUAL_UINT32(25, floats.index.size);
+	for (uint32_t key = 0; key < 50; key++) {
+		TEST_ASSERT_EQUAL(key % 2 == 1, float_set_has(&floats, key));
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Membership */
+	RUN_TEST(testAddZeroed);
+	RUN_TEST(testAddExistingKeepsValue);
+	RUN_TEST(testGetMissing);
+	RUN_TEST(testPagesOnDemand);
+
+	/* Removal */
+	RUN_TEST(testRemoveSwapsLast);
+	RUN_TEST(testRemoveLast);
+	RUN_TEST(testManyKeys);
+
+	/* Joins */
+	RUN_TEST(testJoin);
+	RUN_TEST(testJoinEmpty);
+	RUN_TEST(testJoinRemoveCurrent);
+
+	return UNITY_END();
+}
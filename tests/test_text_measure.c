@@ -0,0 +1,153 @@
+#include <string.h>
+
+#include "clay/text_measure.h"
+#include "unity/unity.h"
+
+/* Longer than two SIMD blocks, so runs end in a block and in the tail */
+enum { MAX_RUN = 40 };
+
+static float advances[128];
+
+void setUp(void)
+{
+	/* Small integers, so every sum is exact in any order */
+	for (int c = 0; c < 128; c++) {
+		advances[c] = (float)(c % 8 + 1);
+	}
+}
+
+void tearDown(void)
+{
+}
+
+static int decode(const char *chars, int length, int *size)
+{
+	return textDecodeUtf8((const unsigned char *)chars, length, size);
+}
+
+static void assertDecodes(int codepoint, int expectedSize, const char *chars)
+{
+	int size = 0;
+	TEST_ASSERT_EQUAL_INT(codepoint,
+			      decode(chars, (int)strlen(chars), &size));
+	TEST_ASSERT_EQUAL_INT(expectedSize, size);
+}
+
+void testDecodeValid(void)
+{
+	assertDecodes('a', 1, "a");
+	assertDecodes(0xE9, 2, "\xC3\xA9");
+	assertDecodes(0x20AC, 3, "\xE2\x82\xAC");
+	assertDecodes(0x1F600, 4, "\xF0\x9F\x98\x80");
+	assertDecodes(0x10FFFF, 4, "\xF4\x8F\xBF\xBF");
+}
+
+void testDecodeMalformed(void)
+{
+	/* Continuation byte without a lead */
+	assertDecodes('?', 1, "\x80");
+	/* Leads of five and six byte sequences */
+	assertDecodes('?', 1, "\xF8\x88\x80\x80\x80");
+	assertDecodes('?', 1, "\xFC\x84\x80\x80\x80\x80");
+	/* Lead followed by ASCII instead of a continuation byte */
+	assertDecodes('?', 1, "\xC3" "A");
+	assertDecodes('?', 1, "\xE2\x82" "A");
+	/* Overlong encodings of '/' */
+	assertDecodes('?', 1, "\xC0\xAF");
+	assertDecodes('?', 1, "\xE0\x80\xAF");
+	assertDecodes('?', 1, "\xF0\x80\x80\xAF");
+	/* Surrogate and past Unicode */
+	assertDecodes('?', 1, "\xED\xA0\x80");
+	assertDecodes('?', 1, "\xF4\x90\x80\x80");
+}
+
+void testDecodeTruncated(void)
+{
+	/* The sequences are complete in memory, the length cuts them short */
+	const char *euro = "\xE2\x82\xAC";
+	const char *emoji = "\xF0\x9F\x98\x80";
+	int size = 0;
+
+	for (int length = 1; length < 3; length++) {
+		TEST_ASSERT_EQUAL_INT('?', decode(euro, length, &size));
+		TEST_ASSERT_EQUAL_INT(1, size);
+	}
+	for (int length = 1; length < 4; length++) {
+		TEST_ASSERT_EQUAL_INT('?', decode(emoji, length, &size));
+		TEST_ASSERT_EQUAL_INT(1, size);
+	}
+}
+
+void testRunLengthAllAscii(void)
+{
+	unsigned char chars[MAX_RUN];
+	memset(chars, 'x', sizeof(chars));
+
+	for (int length = 0; length <= MAX_RUN; length++) {
+		TEST_ASSERT_EQUAL_INT(length, textAsciiRunLength(chars, length));
+	}
+}
+
+/* A run stops at `stop` wherever it lands, in the first block, in a later
+ * one or in the tail */
+static void assertRunStopsAt(unsigned char stop)
+{
+	unsigned char chars[MAX_RUN];
+
+	for (int length = 17; length <= MAX_RUN; length++) {
+		for (int at = 0; at < length; at++) {
+			memset(chars, 'x', sizeof(chars));
+			chars[at] = stop;
+			TEST_ASSERT_EQUAL_INT(at,
+				textAsciiRunLength(chars, length));
+		}
+	}
+}
+
+void testRunLengthStopsAtNonAscii(void)
+{
+	assertRunStopsAt(0x80);
+	assertRunStopsAt(0xC3);
+	assertRunStopsAt(0xFF);
+}
+
+void testRunLengthStopsAtNewline(void)
+{
+	assertRunStopsAt('\n');
+}
+
+void testSumAsciiAdvances(void)
+{
+	unsigned char chars[MAX_RUN];
+	for (int i = 0; i < MAX_RUN; i++) {
+		chars[i] = (unsigned char)(' ' + i * 7 % 95);
+	}
+
+	/* Every tail length after the blocks of 8 and 4 */
+	for (int length = 0; length <= MAX_RUN; length++) {
+		float expected = 0;
+		for (int i = 0; i < length; i++) {
+			expected += advances[chars[i]];
+		}
+		TEST_ASSERT_EQUAL_FLOAT(expected,
+			textSumAsciiAdvances(advances, chars, length));
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* UTF-8 */
+	RUN_TEST(testDecodeValid);
+	RUN_TEST(testDecodeMalformed);
+	RUN_TEST(testDecodeTruncated);
+
+	/* ASCII runs */
+	RUN_TEST(testRunLengthAllAscii);
+	RUN_TEST(testRunLengthStopsAtNonAscii);
+	RUN_TEST(testRunLengthStopsAtNewline);
+	RUN_TEST(testSumAsciiAdvances);
+
+	return UNITY_END();
+}
@@ -0,0 +1,258 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+#include "thread.h"
+
+#include "unity/unity.h"
+
+#define THREAD_COUNT 4
+#define THREAD_SPANS 1000
+/* Not a divisor of LAZ_TRACE_BUFFER_SPANS, a span and the one overwriting it
+ * have different labels */
+#define LAP_LABELS 7
+#define LAP_READS 200
+
+struct Collected {
+	struct laz_span spans[LAZ_TRACE_BUFFER_SPANS * (THREAD_COUNT + 1)];
+	u32 threads[LAZ_TRACE_BUFFER_SPANS * (THREAD_COUNT + 1)];
+	size_t count;
+};
+
+static struct Collected collected;
+
+void setUp(void)
+{
+	laz_trace_init();
+	laz_trace_set_enabled(1);
+	memset(&collected, 0, sizeof(collected));
+}
+
+void tearDown(void)
+{
+	laz_trace_set_enabled(0);
+	laz_trace_cleanup();
+}
+
+static void collect(const struct laz_span *span, u32 thread, void *ctx)
+{
+	struct Collected *out = ctx;
+
+	out->spans[out->count] = *span;
+	out->threads[out->count] = thread;
+	out->count++;
+}
+
+static size_t countNamed(const char *name)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < collected.count; i++) {
+		count += strcmp(collected.spans[i].name, name) == 0;
+	}
+
+	return count;
+}
+
+void testMonotonicClock(void)
+{
+	u64 previous = get_nanoseconds();
+
+	for (int i = 0; i < 10000; i++) {
+		u64 now = get_nanoseconds();
+		TEST_ASSERT_TRUE(now >= previous);
+		previous = now;
+	}
+}
+
+void testTicksToNanoseconds(void)
+{
+	u64 before = get_nanoseconds();
+	u64 ticks = get_ticks();
+	thrd_sleep(&(struct timespec) { .tv_nsec = 20000000 }, NULL);
+	u64 after = get_nanoseconds();
+
+	/* The reading lands between the two clock readings, give or take
+	 * calibration error */
+	u64 converted = ticks_to_nanoseconds(ticks);
+	TEST_ASSERT_TRUE(converted + 1000000 >= before);
+	TEST_ASSERT_TRUE(converted <= after);
+}
+
+void testSpanRecorded(void)
+{
+	u64 before = get_nanoseconds();
+	u64 start = laz_trace_begin();
+	laz_trace_end("work", start);
+
+	laz_trace_foreach(collect, &collected);
+
+	TEST_ASSERT_EQUAL_size_t(1, collected.count);
+	TEST_ASSERT_EQUAL_STRING("work", collected.spans[0].name);
+	TEST_ASSERT_EQUAL_UINT32(1, collected.threads[0]);
+	TEST_ASSERT_TRUE(collected.spans[0].end >= collected.spans[0].start);
+	TEST_ASSERT_TRUE(collected.spans[0].start + 1000000 >= before);
+}
+
+static void scoped(void)
+{
+	LAZ_TRACE_SCOPE("scoped");
+}
+
+void testScope(void)
+{
+	scoped();
+	scoped();
+
+	laz_trace_foreach(collect, &collected);
+	TEST_ASSERT_EQUAL_size_t(2, countNamed("scoped"));
+}
+
+void testDisabledRecordsNothing(void)
+{
+	laz_trace_set_enabled(0);
+
+	u64 start = laz_trace_begin();
+	TEST_ASSERT_EQUAL_UINT64(0, start);
+	laz_trace_end("work", start);
+
+	laz_trace_foreach(collect, &collected);
+	TEST_ASSERT_EQUAL_size_t(0, collected.count);
+}
+
+void testFullBufferKeepsLatest(void)
+{
+	laz_trace_end("old", laz_trace_begin());
+	for (int i = 0; i < LAZ_TRACE_BUFFER_SPANS; i++) {
+		laz_trace_end("new", laz_trace_begin());
+	}
+
+	laz_trace_foreach(collect, &collected);
+	TEST_ASSERT_EQUAL_size_t(LAZ_TRACE_BUFFER_SPANS - 1, collected.count);
+	TEST_ASSERT_EQUAL_size_t(0, countNamed("old"));
+
+	/* Oldest first */
+	for (size_t i = 1; i < collected.count; i++) {
+		TEST_ASSERT_TRUE(collected.spans[i].start
+				 >= collected.spans[i - 1].start);
+	}
+}
+
+static int traceThread(void *arg)
+{
+	(void)arg;
+
+	for (int i = 0; i < THREAD_SPANS; i++) {
+		LAZ_TRACE_SCOPE("thread");
+	}
+
+	return 0;
+}
+
+void testThreadsHaveOwnBuffers(void)
+{
+	thrd_t threads[THREAD_COUNT];
+
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		TEST_ASSERT_EQUAL(thrd_success,
+				  thrd_create(&threads[i], traceThread, NULL));
+	}
+	/* Reading while the threads trace is allowed */
+	struct Collected *concurrent = malloc_try(sizeof(struct Collected));
+	concurrent->count = 0;
+	laz_trace_foreach(collect, concurrent);
+	free(concurrent);
+
+	for (int i = 0; i < THREAD_COUNT; i++) {
+		thrd_join(threads[i], NULL);
+	}
+
+	laz_trace_foreach(collect, &collected);
+	TEST_ASSERT_EQUAL_size_t(THREAD_COUNT * THREAD_SPANS, countNamed("thread"));
+
+	u32 spansPerThread[THREAD_COUNT + 1] = { 0 };
+	for (size_t i = 0; i < collected.count; i++) {
+		TEST_ASSERT_TRUE(collected.threads[i] >= 1);
+		TEST_ASSERT_TRUE(collected.threads[i] <= THREAD_COUNT);
+		spansPerThread[collected.threads[i]]++;
+	}
+	for (int i = 1; i <= THREAD_COUNT; i++) {
+		TEST_ASSERT_EQUAL_UINT32(THREAD_SPANS, spansPerThread[i]);
+	}
+}
+
+static const char lapLabels[LAP_LABELS] = { 0 };
+static atomic_bool lapStop;
+
+/* Each label always goes with the same start, in ticks */
+static int lapThread(void *arg)
+{
+	(void)arg;
+
+	for (u64 i = 0; !atomic_load(&lapStop); i++) {
+		u64 label = i % LAP_LABELS;
+		laz_trace_end(&lapLabels[label], (label + 1) << 24);
+	}
+
+	return 0;
+}
+
+struct LapCheck {
+	u64 starts[LAP_LABELS];
+	size_t count;
+	bool torn;
+};
+
+static void checkLap(const struct laz_span *span, u32 thread, void *ctx)
+{
+	(void)thread;
+	struct LapCheck *check = ctx;
+	size_t label = (size_t)(span->name - lapLabels);
+
+	/* Within a read, every span of a label was converted the same way */
+	if (check->starts[label] == 0) {
+		check->starts[label] = span->start;
+	}
+	check->torn |= check->starts[label] != span->start;
+	check->count++;
+}
+
+void testReadWhileLapped(void)
+{
+	thrd_t thread;
+
+	atomic_store(&lapStop, false);
+	TEST_ASSERT_EQUAL(thrd_success, thrd_create(&thread, lapThread, NULL));
+
+	for (int i = 0; i < LAP_READS; i++) {
+		struct LapCheck check = { 0 };
+		laz_trace_foreach(checkLap, &check);
+
+		TEST_ASSERT_FALSE(check.torn);
+		TEST_ASSERT_TRUE(check.count < LAZ_TRACE_BUFFER_SPANS);
+	}
+
+	atomic_store(&lapStop, true);
+	thrd_join(thread, NULL);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	/* Clocks */
+	RUN_TEST(testMonotonicClock);
+	RUN_TEST(testTicksToNanoseconds);
+
+	/* Spans */
+	RUN_TEST(testSpanRecorded);
+	RUN_TEST(testScope);
+	RUN_TEST(testDisabledRecordsNothing);
+	RUN_TEST(testFullBufferKeepsLatest);
+	RUN_TEST(testThreadsHaveOwnBuffers);
+	RUN_TEST(testReadWhileLapped);
+
+	return UNITY_END();
+}
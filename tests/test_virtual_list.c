@@ -0,0 +1,197 @@
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "virtual_list.h"
+#include "unity/unity.h"
+
+enum { ROW_COUNT = 1000 };
+
+static struct VirtualList list;
+
+void setUp(void)
+{
+	virtualListInit(&list, 10.0f);
+}
+
+void tearDown(void)
+{
+	virtualListCleanup(&list);
+}
+
+/* Rows of 20 with every tenth one 50, so ten rows and their gaps take 330 */
+static void pushRows(void)
+{
+	for (size_t i = 0; i < ROW_COUNT; i++) {
+		virtualListPush(&list, i % 10 == 9 ? 50.0f : 20.0f);
+	}
+}
+
+/* The spacers, the rows and the gaps between them must add up to the
+ * height of the whole list */
+static float rangeHeight(struct VirtualRange range)
+{
+	float height = 0.0f;
+	size_t parts = 0;
+
+	if (range.first > 0) {
+		height += range.spaceBefore;
+		parts++;
+	}
+	for (size_t i = range.first; i < range.end; i++) {
+		height += list.tops.begin[i + 1] - list.tops.begin[i] - list.gap;
+		parts++;
+	}
+	if (range.end < virtualListCount(&list)) {
+		height += range.spaceAfter;
+		parts++;
+	}
+	if (parts > 1) {
+		height += (float)(parts - 1) * list.gap;
+	}
+
+	return height;
+}
+
+void testEmpty(void)
+{
+	struct VirtualRange range = virtualListRange(&list, 0.0f, 100.0f, 0.0f);
+
+	TEST_ASSERT_EQUAL_size_t(0, virtualListCount(&list));
+	TEST_ASSERT_TRUE(virtualListHeight(&list) == 0.0f);
+	TEST_ASSERT_EQUAL_size_t(0, range.first);
+	TEST_ASSERT_EQUAL_size_t(0, range.end);
+}
+
+void testHeight(void)
+{
+	virtualListPush(&list, 20.0f);
+	TEST_ASSERT_TRUE(virtualListHeight(&list) == 20.0f);
+
+	virtualListPush(&list, 30.0f);
+	TEST_ASSERT_TRUE(virtualListHeight(&list) == 60.0f);
+	TEST_ASSERT_EQUAL_size_t(2, virtualListCount(&list));
+}
+
+void testRangeAtTop(void)
+{
+	pushRows();
+
+	/* Rows 0 to 3 start before 100 */
+	struct VirtualRange range = virtualListRange(&list, 0.0f, 100.0f, 0.0f);
+	TEST_ASSERT_EQUAL_size_t(0, range.first);
+	TEST_ASSERT_EQUAL_size_t(4, range.end);
+	TEST_ASSERT_TRUE(range.spaceBefore == 0.0f);
+	TEST_ASSERT_TRUE(rangeHeight(range) == virtualListHeight(&list));
+}
+
+void testRangeInMiddle(void)
+{
+	pushRows();
+
+	/* Rows 100 and 101 start at 3300 and 3330 */
+	struct VirtualRange range
+		= virtualListRange(&list, 3305.0f, 30.0f, 0.0f);
+	TEST_ASSERT_EQUAL_size_t(100, range.first);
+	TEST_ASSERT_EQUAL_size_t(102, range.end);
+	TEST_ASSERT_TRUE(range.spaceBefore + list.gap == 3300.0f);
+	TEST_ASSERT_TRUE(rangeHeight(range) == virtualListHeight(&list));
+}
+
+void testRangeInGap(void)
+{
+	pushRows();
+
+	/* Between rows 0 and 1 */
+	struct VirtualRange range = virtualListRange(&list, 22.0f, 5.0f, 0.0f);
+	TEST_ASSERT_EQUAL_size_t(1, range.first);
+	TEST_ASSERT_EQUAL_size_t(1, range.end);
+	TEST_ASSERT_TRUE(rangeHeight(range) == virtualListHeight(&list));
+}
+
+void testRangeMargin(void)
+{
+	pushRows();
+
+	struct VirtualRange range
+		= virtualListRange(&list, 3305.0f, 30.0f, 60.0f);
+	/* Row 99 is a tall one, from 3240 to 3290 */
+	TEST_ASSERT_EQUAL_size_t(99, range.first);
+	TEST_ASSERT_EQUAL_size_t(104, range.end);
+	TEST_ASSERT_TRUE(rangeHeight(range) == virtualListHeight(&list));
+}
+
+void testRangePastEnd(void)
+{
+	pushRows();
+
+	float height = virtualListHeight(&list);
+	struct VirtualRange range
+		= virtualListRange(&list, height + 100.0f, 100.0f, 0.0f);
+	TEST_ASSERT_EQUAL_size_t(ROW_COUNT, range.first);
+	TEST_ASSERT_EQUAL_size_t(ROW_COUNT, range.end);
+	TEST_ASSERT_TRUE(range.spaceBefore == height);
+}
+
+void testClear(void)
+{
+	pushRows();
+	virtualListClear(&list, 4.0f);
+	TEST_ASSERT_EQUAL_size_t(0, virtualListCount(&list));
+
+	virtualListPush(&list, 20.0f);
+	virtualListPush(&list, 20.0f);
+	TEST_ASSERT_TRUE(virtualListHeight(&list) == 44.0f);
+}
+
+void testResizeMovesLaterRows(void)
+{
+	pushRows();
+	float height = virtualListHeight(&list);
+	float last = virtualListTop(&list, ROW_COUNT - 1);
+
+	/* Rows 10 and 11, 20 high, become 35 and 15 */
+	const float heights[] = { 35.0f, 15.0f };
+	virtualListResize(&list, 10, heights, 2);
+
+	TEST_ASSERT_TRUE(virtualListTop(&list, 10) == 330.0f);
+	TEST_ASSERT_TRUE(virtualListRowHeight(&list, 10) == 35.0f);
+	TEST_ASSERT_TRUE(virtualListTop(&list, 11) == 375.0f);
+	TEST_ASSERT_TRUE(virtualListRowHeight(&list, 11) == 15.0f);
+	TEST_ASSERT_TRUE(virtualListTop(&list, 12) == 400.0f);
+	TEST_ASSERT_TRUE(virtualListTop(&list, ROW_COUNT - 1) == last + 10.0f);
+	TEST_ASSERT_TRUE(virtualListHeight(&list) == height + 10.0f);
+
+	struct VirtualRange range
+		= virtualListRange(&list, 3305.0f, 30.0f, 60.0f);
+	TEST_ASSERT_TRUE(rangeHeight(range) == virtualListHeight(&list));
+}
+
+void testResizeLastRow(void)
+{
+	pushRows();
+	float height = virtualListHeight(&list);
+
+	const float heights[] = { 20.0f };
+	virtualListResize(&list, ROW_COUNT - 1, heights, 1);
+
+	TEST_ASSERT_TRUE(virtualListRowHeight(&list, ROW_COUNT - 1) == 20.0f);
+	TEST_ASSERT_TRUE(virtualListHeight(&list) == height - 30.0f);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(testEmpty);
+	RUN_TEST(testHeight);
+	RUN_TEST(testRangeAtTop);
+	RUN_TEST(testRangeInMiddle);
+	RUN_TEST(testRangeInGap);
+	RUN_TEST(testRangeMargin);
+	RUN_TEST(testRangePastEnd);
+	RUN_TEST(testClear);
+	RUN_TEST(testResizeMovesLaterRows);
+	RUN_TEST(testResizeLastRow);
+
+	return UNITY_END();
+}
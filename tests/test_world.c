@@ -0,0 +1,112 @@
+#define LAZ_UTILS_IMPLEMENTATION
+#include "laz_utils.h"
+
+#include "query.h"
+#include "world.h"
+#include "unity/unity.h"
+
+static struct World world;
+static EntityIdx matches[MAX_ENTITIES];
+
+void setUp(void)
+{
+	initArena();
+	worldInit(&world);
+}
+
+void tearDown(void)
+{
+	cleanupArena();
+}
+
+/* Collect a room's entities, return how many */
+static size_t collect(RoomIdx room, EntityIdx *out, size_t max)
+{
+	struct LocationIterator iter = locationGetEntities(&world.locations,
+							   room);
+	EntityIdx entity = 0;
+	size_t count = 0;
+
+	while (locationIteratorNext(&iter, &entity)) {
+		TEST_ASSERT_TRUE(count < max);
+		out[count++] = entity;
+	}
+
+	return count;
+}
+
+static size_t queryTypes(EntityType types, RoomIdx room)
+{
+	struct EntityQuery query = {
+		.anyTypes = types,
+		.room = room,
+		.minHealth = QUERY_ANY_HEALTH,
+	};
+
+	return entityQuery(&world.entities, &query, matches);
+}
+
+void testSpawnInRoom(void)
+{
+	EntityId id = worldSpawn(&world, 4);
+	EntityIdx entity = ENTITY_ID_INDEX(id);
+	EntityIdx listed[2];
+
+	TEST_ASSERT_EQUAL_size_t(1, collect(4, listed, 2));
+	TEST_ASSERT_EQUAL_UINT16(entity, listed[0]);
+	TEST_ASSERT_EQUAL_UINT16(4, ENTITY(&world.entities, location, entity));
+}
+
+void testDespawnLeavesRoomAndQueries(void)
+{
+	EntityId id = worldSpawn(&world, 2);
+	EntityIdx entity = ENTITY_ID_INDEX(id);
+	ENTITY(&world.entities, types, entity) = TYPE_UNDEAD;
+	locationMove(&world.locations, &world.entities, entity, 3);
+
+	TEST_ASSERT_EQUAL_size_t(1, queryTypes(TYPE_UNDEAD, 3));
+	TEST_ASSERT_TRUE(worldDespawn(&world, id));
+	TEST_ASSERT_FALSE(worldDespawn(&world, id));
+
+	TEST_ASSERT_EQUAL_UINT32(0, locationCount(&world.locations, 2));
+	TEST_ASSERT_EQUAL_UINT32(0, locationCount(&world.locations, 3));
+	TEST_ASSERT_EQUAL_size_t(0, queryTypes(TYPE_UNDEAD, 0));
+	TEST_ASSERT_EQUAL_size_t(0, queryTypes(0, 3));
+}
+
+/* The respawned slot is linked once, next to an entity that stayed */
+void testRespawnRelinksOnce(void)
+{
+	EntityId stays = worldSpawn(&world, 5);
+	EntityId id = worldSpawn(&world, 5);
+	EntityIdx entity = ENTITY_ID_INDEX(id);
+	ENTITY(&world.entities, types, entity) = TYPE_BEAST;
+	locationMove(&world.locations, &world.entities, entity, 6);
+	worldDespawn(&world, id);
+
+	EntityId again = worldSpawn(&world, 6);
+	TEST_ASSERT_EQUAL_UINT16(entity, ENTITY_ID_INDEX(again));
+	ENTITY(&world.entities, types, entity) = TYPE_KOBOLD;
+	locationMove(&world.locations, &world.entities, entity, 5);
+
+	EntityIdx listed[3];
+	TEST_ASSERT_EQUAL_size_t(2, collect(5, listed, 3));
+	TEST_ASSERT_EQUAL_UINT16(entity, listed[0]);
+	TEST_ASSERT_EQUAL_UINT16(ENTITY_ID_INDEX(stays), listed[1]);
+	TEST_ASSERT_EQUAL_UINT32(0, locationCount(&world.locations, 6));
+
+	TEST_ASSERT_EQUAL_size_t(0, queryTypes(TYPE_BEAST, 0));
+	TEST_ASSERT_EQUAL_size_t(1, queryTypes(TYPE_KOBOLD, 5));
+	TEST_ASSERT_EQUAL_UINT16(entity, matches[0]);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+
+	RUN_TEST(testSpawnInRoom);
+	RUN_TEST(testDespawnLeavesRoomAndQueries);
+	RUN_TEST(testRespawnRelinksOnce);
+
+	return UNITY_END();
+}